@@ -0,0 +1,41 @@
+#include "jbenchmark.h"
+
+#include <cstdlib>
+#include <new>
+
+void * operator new(std::size_t size)
+{
+  jmixin::benchmark::Allocations::count.fetch_add(1, std::memory_order_relaxed);
+  jmixin::benchmark::Allocations::bytes.fetch_add(size, std::memory_order_relaxed);
+
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void * operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
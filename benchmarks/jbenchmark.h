@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace jmixin {
+
+  namespace benchmark {
+
+    // Updated by the replaced global operator new (see allocations.cpp).
+    struct Allocations {
+      static inline std::atomic<std::size_t> count {0};
+      static inline std::atomic<std::size_t> bytes {0};
+    };
+
+    struct Result {
+      std::string group;
+      std::string name;
+      std::string policy;
+      std::size_t size;
+      std::size_t iterations;
+      double ns_per_element;
+      double allocations;
+      double bytes;
+    };
+
+    // Runs every case over sizes from --min-size to --max-size (powers of
+    // ten), repeating it until --min-time milliseconds were measured. The
+    // setup of each iteration is excluded from the time and allocations.
+    class Suite {
+
+      public:
+        Suite(int argc, char **argv)
+        {
+          for (int i=1; i<argc; i++) {
+            std::string arg {argv[i]};
+            std::string value = i + 1 < argc ? argv[i + 1] : "";
+
+            if (arg == "--min-size") {
+              _min_size = std::stoull(value), i++;
+            } else if (arg == "--max-size") {
+              _max_size = std::stoull(value), i++;
+            } else if (arg == "--min-time") {
+              _min_time = std::stod(value), i++;
+            } else if (arg == "--filter") {
+              _filter = value, i++;
+            } else if (arg == "--json") {
+              _json = value, i++;
+            } else {
+              std::cout << "usage: " << argv[0] << " [--min-size n] [--max-size n] [--min-time ms] [--filter text] [--json file]" << std::endl;
+
+              std::exit(0);
+            }
+          }
+
+          std::cout << std::left << std::setw(16) << "group" << std::setw(24) << "name" << std::setw(24) << "policy" << std::right
+            << std::setw(12) << "size" << std::setw(14) << "ns/element" << std::setw(12) << "allocs" << std::setw(14) << "bytes" << std::endl;
+        }
+
+        std::vector<std::size_t> sizes(std::size_t limit = static_cast<std::size_t>(-1)) const
+        {
+          std::vector<std::size_t> result;
+
+          for (std::size_t size=10; size<=std::min(_max_size, limit); size*=10) {
+            if (size >= _min_size) {
+              result.push_back(size);
+            }
+          }
+
+          return result;
+        }
+
+        template<typename Setup, typename Body>
+          void run(const std::string &group, const std::string &name, const std::string &policy, std::size_t size, Setup setup, Body body)
+          {
+            if (_filter.empty() == false and (group + "/" + name + "/" + policy).find(_filter) == std::string::npos) {
+              return;
+            }
+
+            // small sizes run in batches so the clock resolution does not matter
+            std::size_t batch = std::max<std::size_t>(1, 100000/std::max<std::size_t>(1, size));
+            std::size_t iterations = 0;
+            std::size_t count = 0;
+            std::size_t bytes = 0;
+            double elapsed = 0.0;
+
+            while (elapsed < _min_time*1e6 or iterations == 0) {
+              std::vector<decltype(setup())> states;
+
+              states.reserve(batch);
+
+              for (std::size_t i=0; i<batch; i++) {
+                states.push_back(setup());
+              }
+
+              std::size_t count0 = Allocations::count.load();
+              std::size_t bytes0 = Allocations::bytes.load();
+
+              auto start = std::chrono::steady_clock::now();
+
+              for (auto &state : states) {
+                escape(body(state));
+              }
+
+              auto end = std::chrono::steady_clock::now();
+
+              count += Allocations::count.load() - count0;
+              bytes += Allocations::bytes.load() - bytes0;
+              elapsed += std::chrono::duration<double, std::nano>(end - start).count();
+              iterations += batch;
+            }
+
+            Result result {group, name, policy, size, iterations, elapsed/iterations/std::max<std::size_t>(1, size), 1.0*count/iterations, 1.0*bytes/iterations};
+
+            std::cout << std::left << std::setw(16) << result.group << std::setw(24) << result.name << std::setw(24) << result.policy << std::right
+              << std::setw(12) << result.size << std::fixed << std::setprecision(3) << std::setw(14) << result.ns_per_element
+              << std::setprecision(1) << std::setw(12) << result.allocations << std::setw(14) << result.bytes << std::endl;
+
+            _results.push_back(result);
+          }
+
+        int finish() const
+        {
+          if (_json.empty() == true) {
+            return 0;
+          }
+
+          std::ofstream out(_json);
+
+          if (!out) {
+            std::clog << "unable to open file '" << _json << "'" << std::endl;
+
+            return 1;
+          }
+
+          out << "[\n";
+
+          for (std::size_t i=0; i<_results.size(); i++) {
+            const auto &result = _results[i];
+
+            out << "  {\"group\": \"" << result.group << "\", \"name\": \"" << result.name << "\", \"policy\": \"" << result.policy
+              << "\", \"size\": " << result.size << ", \"iterations\": " << result.iterations
+              << ", \"ns_per_element\": " << result.ns_per_element << ", \"allocations\": " << result.allocations
+              << ", \"bytes\": " << result.bytes << "}" << (i + 1 < _results.size() ? ",\n" : "\n");
+          }
+
+          out << "]\n";
+
+          return 0;
+        }
+
+      private:
+        std::vector<Result> _results;
+        std::string _filter;
+        std::string _json;
+        std::size_t _min_size {10};
+        std::size_t _max_size {1000000};
+        double _min_time {20.0};
+
+        template<typename T>
+          static void escape(T &&value)
+          {
+            asm volatile("" : : "g"(&value) : "memory");
+          }
+
+    };
+
+  }
+
+}
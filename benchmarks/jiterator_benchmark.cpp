@@ -0,0 +1,389 @@
+#include <deque>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <set>
+
+#include "jbenchmark.h"
+
+#include "jmixin/jgenerator.h"
+#include "jmixin/jiterator.h"
+
+using jmixin::benchmark::Suite;
+
+template<typename Container>
+jmixin::Iterator<Container> make(std::size_t n, bool shuffled)
+{
+  std::vector<int> values(n);
+
+  std::iota(std::begin(values), std::end(values), 0);
+
+  if (shuffled == true) {
+    std::shuffle(std::begin(values), std::end(values), std::mt19937{42});
+  }
+
+  return Container(std::begin(values), std::end(values));
+}
+
+template<typename Container>
+jmixin::Iterator<std::vector<Container>> make_runs(std::size_t n, std::size_t k)
+{
+  std::vector<int> values(n);
+
+  std::iota(std::begin(values), std::end(values), 0);
+  std::shuffle(std::begin(values), std::end(values), std::mt19937{42});
+
+  std::vector<Container> result;
+
+  for (std::size_t i=0; i<k; i++) {
+    auto first = std::begin(values) + i*n/k;
+    auto last = std::begin(values) + (i + 1)*n/k;
+
+    std::sort(first, last);
+
+    result.emplace_back(first, last);
+  }
+
+  return result;
+}
+
+template<typename Container>
+void sequential(Suite &suite, const std::string &group, std::size_t n)
+{
+  constexpr bool sequence = not std::is_same_v<Container, std::set<int>>;
+  constexpr bool random = std::random_access_iterator<typename Container::iterator>;
+
+  auto sorted = make<Container>(n, false);
+  auto shuffled = make<Container>(n, true);
+  auto other = make<Container>(n/2, false);
+
+  auto none = []() { return 0; };
+  auto copy = [&sorted]() { return sorted; };
+  auto copy_shuffled = [&shuffled]() { return shuffled; };
+  auto even = [](const auto &item) { return item % 2 == 0; };
+
+  suite.run(group, "copy", "seq", n, none, [&](int) { return sorted.copy().size(); });
+  suite.run(group, "copy_n", "seq", n, none, [&](int) { return sorted.copy_n(n/2).size(); });
+  suite.run(group, "count", "seq", n, none, [&](int) { return sorted.count(even); });
+  suite.run(group, "eq", "seq", n, none, [&](int) { return sorted.eq(shuffled); });
+  suite.run(group, "lt", "seq", n, none, [&](int) { return sorted.lt(shuffled); });
+  suite.run(group, "le", "seq", n, none, [&](int) { return sorted.le(shuffled); });
+  suite.run(group, "for_each", "seq", n, none, [&](int) {
+      long sum = 0;
+
+      sorted.for_each([&sum](const auto &item) { sum += item; });
+
+      return sum;
+  });
+  suite.run(group, "map", "seq", n, none, [&](int) { return sorted.map([](const auto &item) { return item + 1; }).size(); });
+  suite.run(group, "first", "seq", n, none, [&](int) { return sorted.first(); });
+  suite.run(group, "last", "seq", n, none, [&](int) { return sorted.last(); });
+  suite.run(group, "nth", "seq", n, none, [&](int) { return sorted.nth(n/2); });
+  suite.run(group, "find_first", "seq", n, none, [&](int) { return sorted.find_first([n](const auto &item) { return item == static_cast<int>(n - 1); }); });
+  suite.run(group, "find_last", "seq", n, none, [&](int) { return sorted.find_last(even); });
+  suite.run(group, "min", "seq", n, none, [&](int) { return shuffled.min(); });
+  suite.run(group, "max", "seq", n, none, [&](int) { return shuffled.max(); });
+  suite.run(group, "position", "seq", n, none, [&](int) { return sorted.position([n](const auto &item) { return item == static_cast<int>(n - 1); }); });
+  suite.run(group, "all", "seq", n, none, [&](int) { return sorted.all([](const auto &item) { return item >= 0; }); });
+  suite.run(group, "any", "seq", n, none, [&](int) { return sorted.any([](const auto &item) { return item < 0; }); });
+  suite.run(group, "none", "seq", n, none, [&](int) { return sorted.none([](const auto &item) { return item < 0; }); });
+  suite.run(group, "includes", "seq", n, none, [&](int) { return sorted.includes(other); });
+  suite.run(group, "append", "seq", n, copy, [&](auto &items) { return items.append(other).size(); });
+  suite.run(group, "prepend", "seq", n, copy, [&](auto &items) { return items.prepend(other).size(); });
+  suite.run(group, "enumerate", "seq", n, none, [&](int) { return sorted.enumerate().size(); });
+  suite.run(group, "pairs", "seq", n, none, [&](int) { return sorted.pairs(shuffled).size(); });
+  suite.run(group, "enumerate_view", "seq", n, none, [&](int) { return sorted.enumerate_view().filter([](const auto &item) { return std::get<1>(item) % 2 == 0; }).count(); });
+  suite.run(group, "zip_view", "seq", n, none, [&](int) { return sorted.zip_view(shuffled).filter([](const auto &item) { return std::get<0>(item) < std::get<1>(item); }).count(); });
+  suite.run(group, "breaks", "seq", n, none, [&](int) { return sorted.breaks(64).size(); });
+  suite.run(group, "chunks", "seq", n, none, [&](int) { return sorted.chunks(64).size(); });
+  suite.run(group, "sample", "seq", n, none, [&](int) { return sorted.sample(n/10).size(); });
+  suite.run(group, "contains", "seq", n, none, [&, items=sorted.assume_sorted()](int) { return items.contains(static_cast<int>(n/2)); });
+  suite.run(group, "lazy", "seq", n, none, [&](int) { return sorted.lazy().filter(even).map([](const auto &item) { return item*3; }).take(n/4).sum(); });
+
+  if constexpr (sequence) {
+    suite.run(group, "filter", "seq", n, copy, [&](auto &items) { return items.filter(even).size(); });
+    suite.run(group, "step", "seq", n, copy, [&](auto &items) { return items.step(3).size(); });
+    suite.run(group, "skip", "seq", n, copy, [&](auto &items) { return items.skip(n/2).size(); });
+    suite.run(group, "take", "seq", n, copy, [&](auto &items) { return items.take(n/2).size(); });
+    suite.run(group, "chop", "seq", n, copy, [&](auto &items) { return items.chop(n/2).size(); });
+    suite.run(group, "combine", "seq", n, copy, [&](auto &items) { return items.combine(shuffled, std::plus<>()).size(); });
+    suite.run(group, "fill", "seq", n, copy, [&](auto &items) { return items.fill(1).size(); });
+    suite.run(group, "fill_n", "seq", n, copy, [&](auto &items) { return items.fill_n(n/2, 1).size(); });
+    suite.run(group, "reverse", "seq", n, copy, [&](auto &items) { return items.reverse().size(); });
+    suite.run(group, "left_rotate", "seq", n, copy, [&](auto &items) { return items.left_rotate(n/3).size(); });
+    suite.run(group, "right_rotate", "seq", n, copy, [&](auto &items) { return items.right_rotate(n/3).size(); });
+    suite.run(group, "unique", "seq", n, copy, [&](auto &items) { return items.unique().size(); });
+    suite.run(group, "difference", "seq", n, copy, [&](auto &items) { return items.difference(other).size(); });
+    suite.run(group, "complement", "seq", n, copy, [&](auto &items) { return items.complement(other).size(); });
+    suite.run(group, "intersection", "seq", n, copy, [&](auto &items) { return items.intersection(other).size(); });
+    suite.run(group, "hash_intersection", "seq", n, copy_shuffled, [&](auto &items) { return items.hash_intersection(other).size(); });
+    suite.run(group, "hash_difference", "seq", n, copy_shuffled, [&](auto &items) { return items.hash_difference(other).size(); });
+    suite.run(group, "union_set", "seq", n, copy, [&](auto &items) { return items.union_set(other).size(); });
+    suite.run(group, "merge", "seq", n, copy, [&](auto &items) { return items.merge(other).size(); });
+    suite.run(group, "generate", "seq", n, []() { return jmixin::Iterator<Container>(); }, [&](auto &items) { return items.generate([i=0]() mutable { return i++; }, n).size(); });
+    suite.run(group, "partition", "seq", n, copy, [&](auto &items) { return items.partition(even).size(); });
+    suite.run(group, "partition_view", "seq", n, copy, [&](auto &items) { return std::ranges::distance(items.partition_view(even).first); });
+    suite.run(group, "stable_partition", "seq", n, copy, [&](auto &items) { return items.stable_partition(even).size(); });
+    suite.run(group, "sorted.unique", "seq", n, copy, [&](auto &items) { return std::move(items).assume_sorted().unique().size(); });
+    suite.run(group, "sorted.intersection", "seq", n, copy, [&](auto &items) { return std::move(items).assume_sorted().intersection(other).size(); });
+    suite.run(group, "flatten", "seq", n, none, [&, nested=sorted.breaks(64)](int) { return nested.flatten().size(); });
+  }
+
+  if constexpr (random) {
+    suite.run(group, "sort.intersection", "seq", n, copy_shuffled, [&](auto &items) { return items.sort().intersection(other).size(); });
+    suite.run(group, "sort", "seq", n, copy_shuffled, [&](auto &items) { return items.sort().size(); });
+    suite.run(group, "shuffle", "seq", n, copy, [&](auto &items) { return items.shuffle().size(); });
+    suite.run(group, "sort.take(100)", "seq", n, copy_shuffled, [&](auto &items) { return items.sort(std::greater<>()).take(100).size(); });
+    suite.run(group, "merge.fold(64)", "seq", n, none, [&, runs=make_runs<Container>(n, 64)](int) {
+        jmixin::Iterator<Container> result;
+
+        for (const auto &run : runs) {
+          result.merge(run);
+        }
+
+        return result.size();
+    });
+    suite.run(group, "merge_all(64)", "seq", n, none, [&, runs=make_runs<Container>(n, 64)](int) { return runs.merge_all().size(); });
+    suite.run(group, "merge_view(64)", "seq", n, none, [&, runs=make_runs<Container>(n, 64)](int) { return runs.merge_view().count(); });
+  }
+
+  if constexpr (sequence) {
+    suite.run(group, "top_k(100)", "seq", n, copy_shuffled, [&](auto &items) { return items.top_k(100).size(); });
+  }
+
+  auto bucket = [](const auto &item) { return item % 1024; };
+  auto scatter = [](const auto &item) { return static_cast<long>(item)*2654435761L; };
+
+  suite.run(group, "std::map[key]++", "seq", n, none, [&](int) {
+      std::map<int, std::size_t> counts;
+
+      for (const auto &item : shuffled) {
+        counts[bucket(item)]++;
+      }
+
+      return counts.size();
+  });
+  suite.run(group, "count_by(dense)", "seq", n, none, [&](int) { return shuffled.count_by(bucket).size(); });
+  suite.run(group, "count_by(hash)", "seq", n, none, [&](int) { return shuffled.count_by(scatter).size(); });
+  suite.run(group, "group_by", "seq", n, none, [&](int) { return shuffled.group_by(bucket).size(); });
+  suite.run(group, "reduce_by_key", "seq", n, none, [&](int) { return shuffled.reduce_by_key(bucket, std::plus<>(), 0L).size(); });
+
+#ifdef JMIXIN_JITERATOR_EXTRA
+  suite.run(group, "sum", "seq", n, none, [&](int) { return sorted.template sum<long>(0); });
+  suite.run(group, "product", "seq", n, none, [&](int) { return sorted.template product<long>(1); });
+  suite.run(group, "zip", "seq", n, none, [&](int) { return sorted.zip(std::plus<>(), 0L); });
+  suite.run(group, "for_each_n", "seq", n, none, [&](int) {
+      long sum = 0;
+
+      sorted.for_each_n(n/2, [&sum](const auto &item) { sum += item; });
+
+      return sum;
+  });
+#endif
+}
+
+template<typename Container, typename ExecutionPolicy>
+void parallel(Suite &suite, const std::string &group, const std::string &name, std::size_t n, ExecutionPolicy &&policy)
+{
+  auto sorted = make<Container>(n, false);
+  auto shuffled = make<Container>(n, true);
+  auto other = make<Container>(n/2, false);
+
+  auto none = []() { return 0; };
+  auto copy = [&sorted]() { return sorted; };
+  auto copy_shuffled = [&shuffled]() { return shuffled; };
+  auto even = [](const auto &item) { return item % 2 == 0; };
+
+  suite.run(group, "copy", name, n, none, [&](int) { return sorted.copy(policy).size(); });
+  suite.run(group, "copy_n", name, n, none, [&](int) { return sorted.copy_n(policy, n/2).size(); });
+  suite.run(group, "count", name, n, none, [&](int) { return sorted.count(policy, even); });
+  suite.run(group, "eq", name, n, none, [&](int) { return sorted.eq(policy, sorted); });
+  suite.run(group, "lt", name, n, none, [&](int) { return sorted.lt(policy, sorted); });
+  suite.run(group, "for_each", name, n, none, [&](int) {
+      std::atomic<long> sum = 0;
+
+      sorted.for_each(policy, [&sum](const auto &item) { sum.fetch_add(item, std::memory_order_relaxed); }, nullptr, nullptr);
+
+      return sum.load();
+  });
+  suite.run(group, "for_each_chunk", name, n, copy, [&](auto &items) {
+      std::atomic<long> sum = 0;
+
+      items.for_each_chunk(policy, 1024, [&sum](auto chunk) { sum.fetch_add(std::accumulate(std::begin(chunk), std::end(chunk), 0L), std::memory_order_relaxed); });
+
+      return sum.load();
+  });
+  suite.run(group, "for_each_batch", name, n, copy, [&](auto &items) {
+      std::atomic<long> sum = 0;
+
+      items.for_each_batch(policy, 1024, [&sum](auto batch) { sum.fetch_add(std::accumulate(std::begin(batch), std::end(batch), 0L), std::memory_order_relaxed); });
+
+      return sum.load();
+  });
+  suite.run(group, "flatten", name, n, none, [&, nested=sorted.breaks(64)](int) { return nested.flatten(policy).size(); });
+  suite.run(group, "map", name, n, none, [&](int) { return sorted.map(policy, [](const auto &item) { return item + 1; }).size(); });
+  suite.run(group, "position", name, n, none, [&](int) { return sorted.position(policy, [n](const auto &item) { return item == static_cast<int>(n - 1); }); });
+  suite.run(group, "all", name, n, none, [&](int) { return sorted.all(policy, [](const auto &item) { return item >= 0; }); });
+  suite.run(group, "any", name, n, none, [&](int) { return sorted.any(policy, [](const auto &item) { return item < 0; }); });
+  suite.run(group, "none", name, n, none, [&](int) { return sorted.none(policy, [](const auto &item) { return item < 0; }); });
+  suite.run(group, "includes", name, n, none, [&](int) { return sorted.includes(policy, other); });
+  suite.run(group, "filter", name, n, copy, [&](auto &items) { return items.filter(policy, even).size(); });
+  suite.run(group, "step", name, n, copy, [&](auto &items) { return items.step(policy, 3).size(); });
+  suite.run(group, "skip", name, n, copy, [&](auto &items) { return items.skip(policy, n/2).size(); });
+  suite.run(group, "take", name, n, copy, [&](auto &items) { return items.take(policy, n/2).size(); });
+  suite.run(group, "fill", name, n, copy, [&](auto &items) { return items.fill(policy, 1).size(); });
+  suite.run(group, "fill_n", name, n, copy, [&](auto &items) { return items.fill_n(policy, n/2, 1).size(); });
+  suite.run(group, "reverse", name, n, copy, [&](auto &items) { return items.reverse(policy).size(); });
+  suite.run(group, "left_rotate", name, n, copy, [&](auto &items) { return items.left_rotate(policy, n/3).size(); });
+  suite.run(group, "right_rotate", name, n, copy, [&](auto &items) { return items.right_rotate(policy, n/3).size(); });
+  suite.run(group, "sort", name, n, copy_shuffled, [&](auto &items) { return items.sort(policy, std::less<>()).size(); });
+  suite.run(group, "shuffle", name, n, copy, [&](auto &items) { return items.shuffle(policy).size(); });
+  suite.run(group, "top_k(100)", name, n, copy_shuffled, [&](auto &items) { return items.top_k(policy, 100, std::less<>()).size(); });
+  suite.run(group, "count_by(dense)", name, n, none, [&](int) { return shuffled.count_by(policy, [](const auto &item) { return item % 1024; }).size(); });
+  suite.run(group, "count_by(hash)", name, n, none, [&](int) { return shuffled.count_by(policy, [](const auto &item) { return static_cast<long>(item)*2654435761L; }).size(); });
+  suite.run(group, "group_by", name, n, none, [&](int) { return shuffled.group_by(policy, [](const auto &item) { return item % 1024; }).size(); });
+  suite.run(group, "reduce_by_key", name, n, none, [&](int) { return shuffled.reduce_by_key(policy, [](const auto &item) { return item % 1024; }, std::plus<>(), 0L).size(); });
+  suite.run(group, "unique", name, n, copy, [&](auto &items) { return items.unique(policy).size(); });
+  suite.run(group, "difference", name, n, copy, [&](auto &items) { return items.difference(policy, other).size(); });
+  suite.run(group, "complement", name, n, copy, [&](auto &items) { return items.complement(policy, other).size(); });
+  suite.run(group, "intersection", name, n, copy, [&](auto &items) { return items.intersection(policy, other).size(); });
+  suite.run(group, "hash_intersection", name, n, copy_shuffled, [&](auto &items) { return items.hash_intersection(policy, other).size(); });
+  suite.run(group, "union_set", name, n, copy, [&](auto &items) { return items.union_set(policy, other).size(); });
+  suite.run(group, "merge", name, n, copy, [&](auto &items) { return items.merge(policy, other).size(); });
+  suite.run(group, "merge_all(64)", name, n, none, [&, runs=make_runs<Container>(n, 64)](int) { return runs.merge_all(policy).size(); });
+  suite.run(group, "append", name, n, copy, [&](auto &items) { return items.append(policy, other).size(); });
+  suite.run(group, "prepend", name, n, copy, [&](auto &items) { return items.prepend(policy, other).size(); });
+  suite.run(group, "partition", name, n, copy, [&](auto &items) { return items.partition(policy, even).size(); });
+  suite.run(group, "partition_view", name, n, copy, [&](auto &items) { return std::ranges::distance(items.partition_view(policy, even).first); });
+  suite.run(group, "stable_partition", name, n, copy, [&](auto &items) { return items.stable_partition(policy, even).size(); });
+
+#ifdef JMIXIN_JITERATOR_EXTRA
+  suite.run(group, "sum", name, n, none, [&](int) { return sorted.sum(policy, 0); });
+  suite.run(group, "product", name, n, none, [&](int) { return sorted.product(policy, 1); });
+  suite.run(group, "zip", name, n, none, [&](int) { return sorted.zip(policy, std::plus<>(), 0); });
+#endif
+}
+
+template<typename T>
+void arithmetic(Suite &suite, const std::string &group, std::size_t n)
+{
+  jmixin::Iterator<std::vector<T>> items;
+
+  items.generate([i=0]() mutable { return static_cast<T>((i++*7919) % 1000); }, n);
+
+  auto none = []() { return 0; };
+
+  for (auto [level, name] : {std::pair{jmixin::simd::isa::scalar, "scalar"}, {jmixin::simd::isa::sse2, "sse2"}, {jmixin::simd::isa::avx2, "avx2"}}) {
+    jmixin::simd::limit(level);
+
+    if (jmixin::simd::level() != level) {
+      continue;
+    }
+
+    suite.run(group, "min", name, n, none, [&](int) { return *items.min(); });
+    suite.run(group, "max", name, n, none, [&](int) { return *items.max(); });
+    suite.run(group, "minmax", name, n, none, [&](int) { return items.minmax()->max_position; });
+
+#ifdef JMIXIN_JITERATOR_EXTRA
+    suite.run(group, "sum", name, n, none, [&](int) { return items.sum(T{0}); });
+    suite.run(group, "product", name, n, none, [&](int) { return items.product(T{1}); });
+#endif
+  }
+
+  suite.run(group, "minmax_element", "std", n, none, [&](int) { return std::minmax_element(std::begin(items), std::end(items)).second - std::begin(items); });
+}
+
+// Taking the first n/10 even draws: generate() makes all the n draws up front,
+// a generator only the ones the pipeline consumes.
+void sources(Suite &suite, const std::string &group, std::size_t n)
+{
+  auto none = []() { return 0; };
+  auto even = [](int item) { return item % 2 == 0; };
+
+  suite.run(group, "generate.filter.take", "seq", n, none, [&](int) {
+      return jmixin::Iterator<std::vector<int>>().generate([i=0]() mutable { return i++; }, n).filter(even).take(n/10).size();
+  });
+
+  suite.run(group, "from_function.lazy", "seq", n, none, [&](int) {
+      return jmixin::from_function([i=0]() mutable { return i++; }).lazy().filter(even).take(n/10).collect().size();
+  });
+
+  suite.run(group, "iota.lazy", "seq", n, none, [&](int) {
+      return jmixin::iota(0).lazy().filter(even).take(n/10).collect().size();
+  });
+}
+
+// The same pipeline over std::allocator and over std::pmr resources; the
+// arena is released at once after every run.
+void allocators(Suite &suite, const std::string &group, std::size_t n)
+{
+  auto values = make<std::vector<int>>(n, true);
+  auto other = make<std::vector<int>>(n/2, false);
+
+  auto none = []() { return 0; };
+
+  auto pipeline = [&other](auto items) {
+    auto sorted = jmixin::Iterator(std::move(items))
+      .map([](int item) { return item*3; })
+      .filter([](int item) { return item % 2 == 0; })
+      .sort();
+
+    sorted.difference(other).merge(other);
+
+    return sorted.breaks(64).flatten().partition([](int item) { return item % 4 == 0; })[0].size();
+  };
+
+  suite.run(group, "pipeline", "std::allocator", n, none, [&](int) {
+      return pipeline(std::vector<int>(std::begin(values), std::end(values)));
+  });
+
+  std::pmr::unsynchronized_pool_resource pool;
+
+  suite.run(group, "pipeline", "pmr::pool", n, none, [&](int) {
+      return pipeline(std::pmr::vector<int>(std::begin(values), std::end(values), &pool));
+  });
+
+  jmixin::Arena arena(16*n*sizeof(int));
+
+  suite.run(group, "pipeline", "jmixin::Arena", n, none, [&](int) {
+      auto result = pipeline(std::pmr::vector<int>(std::begin(values), std::end(values), arena.allocator<int>()));
+
+      arena.release();
+
+      return result;
+  });
+}
+
+int main(int argc, char **argv)
+{
+  Suite suite(argc, argv);
+
+  jmixin::Executor executor;
+
+  std::string executor_name = "jmixin::par(" + std::to_string(executor.workers()) + ")";
+
+  for (auto n : suite.sizes()) {
+    sequential<std::vector<int>>(suite, "vector", n);
+    sequential<std::deque<int>>(suite, "deque", n);
+    sequential<std::list<int>>(suite, "list", n);
+    sequential<std::set<int>>(suite, "set", n);
+
+    arithmetic<int>(suite, "vector<int>", n);
+    arithmetic<float>(suite, "vector<float>", n);
+    arithmetic<double>(suite, "vector<double>", n);
+
+    allocators(suite, "allocator", n);
+    sources(suite, "source", n);
+
+    parallel<std::vector<int>>(suite, "vector", executor_name, n, jmixin::par(executor));
+    parallel<std::deque<int>>(suite, "deque", executor_name, n, jmixin::par(executor));
+
+#ifdef JMIXIN_JITERATOR_PARALLEL
+    parallel<std::vector<int>>(suite, "vector", "std::execution::par", n, std::execution::par);
+    parallel<std::deque<int>>(suite, "deque", "std::execution::par", n, std::execution::par);
+#endif
+  }
+
+  return suite.finish();
+}
@@ -0,0 +1,56 @@
+#include "jbenchmark.h"
+
+#include "jmixin/jlines.h"
+
+#include <cstdio>
+#include <random>
+
+using jmixin::benchmark::Suite;
+
+// A file with n lines of 1 to 80 letters.
+void make(const std::string &path, std::size_t n)
+{
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> letter{'a', 'z'};
+  std::uniform_int_distribution<int> length{1, 80};
+
+  std::ofstream out(path);
+
+  for (std::size_t i=0; i<n; i++) {
+    out << std::string(length(generator), static_cast<char>(letter(generator))) << '\n';
+  }
+}
+
+int main(int argc, char **argv)
+{
+  Suite suite(argc, argv);
+
+  const std::string path = "jlines_benchmark.txt";
+
+  for (auto n : suite.sizes()) {
+    make(path, n);
+
+    auto none = []() { return 0; };
+
+    suite.run("lines", "std::getline", "seq", n, none, [&](int) {
+        std::ifstream in(path);
+        std::vector<std::string> result;
+        std::string line;
+
+        while (std::getline(in, line)) {
+          result.push_back(line);
+        }
+
+        return result.size();
+    });
+
+    suite.run("lines", "lines", "seq", n, none, [&](int) { return jmixin::lines(path).size(); });
+    suite.run("lines", "lines.filter", "seq", n, none, [&](int) {
+        return jmixin::lines(path).filter([](std::string_view item) { return item.size() > 40; }).size();
+    });
+  }
+
+  std::remove(path.c_str());
+
+  return suite.finish();
+}
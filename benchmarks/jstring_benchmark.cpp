@@ -0,0 +1,81 @@
+#include "jbenchmark.h"
+
+#include "jmixin/jstring.h"
+
+#include <random>
+
+using jmixin::benchmark::Suite;
+
+jmixin::String make(std::size_t n)
+{
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> letter{'a', 'z'};
+  std::uniform_int_distribution<int> word{1, 10};
+
+  jmixin::String result;
+
+  while (result.size() < n) {
+    for (int i=word(generator); i>0 and result.size() < n; i--) {
+      result.push_back(static_cast<char>(letter(generator)));
+    }
+
+    if (result.size() < n) {
+      result.push_back(' ');
+    }
+  }
+
+  return result;
+}
+
+int main(int argc, char **argv)
+{
+  Suite suite(argc, argv);
+
+  // some methods are quadratic, so their sizes are limited
+  constexpr std::size_t quadratic = 10000;
+
+  for (auto n : suite.sizes()) {
+    auto text = make(n);
+    auto other = make(n/2 + 1);
+    auto hex = text.hex();
+    auto url = jmixin::String{text}.encode_url();
+
+    auto none = []() { return 0; };
+    auto copy = [&text]() { return text; };
+
+    suite.run("string", "lower_case", "seq", n, none, [&](int) { return text.lower_case().size(); });
+    suite.run("string", "upper_case", "seq", n, none, [&](int) { return text.upper_case().size(); });
+    suite.run("string", "swap_case", "seq", n, none, [&](int) { return text.swap_case().size(); });
+    suite.run("string", "captalize", "seq", n, none, [&](int) { return text.captalize().size(); });
+    suite.run("string", "trim", "seq", n, none, [&](int) { return text.trim().size(); });
+    suite.run("string", "starts_with", "seq", n, none, [&](int) { return text.starts_with(other); });
+    suite.run("string", "ends_with", "seq", n, none, [&](int) { return text.ends_with(other); });
+    suite.run("string", "repeat", "seq", n, none, [&](int) { return text.repeat(4, ",").size(); });
+    suite.run("string", "center", "seq", n, none, [&](int) { return text.center(2*n).size(); });
+    suite.run("string", "ellipses", "seq", n, none, [&](int) { return text.ellipses(n/2 + 3).size(); });
+    suite.run("string", "is_blank", "seq", n, none, [&](int) { return text.is_blank(); });
+    suite.run("string", "is_lower_case", "seq", n, none, [&](int) { return text.is_lower_case(); });
+    suite.run("string", "is_alpha", "seq", n, none, [&](int) { return text.is_alpha(); });
+    suite.run("string", "asciify", "seq", n, none, [&](int) { return text.asciify().size(); });
+    suite.run("string", "encode_url", "seq", n, copy, [&](auto &value) { return value.encode_url().size(); });
+    suite.run("string", "decode_url", "seq", n, [&url]() { return url; }, [&](auto &value) { return value.decode_url().size(); });
+    suite.run("string", "iterator", "seq", n, none, [&](int) { return text.iterator().count([](char c) { return c == ' '; }); });
+
+    if (n <= quadratic) {
+      suite.run("string", "hex", "seq", n, none, [&](int) { return text.hex().size(); });
+      suite.run("string", "from_hex", "seq", n, none, [&](int) { return jmixin::from_hex(hex).size(); });
+      suite.run("string", "replace", "seq", n, none, [&](int) { return text.replace("[aeiou]", "*").size(); });
+      suite.run("string", "remove", "seq", n, none, [&](int) { return text.remove("[aeiou]").size(); });
+      suite.run("string", "split", "seq", n, none, [&](int) { return text.split().size(); });
+      suite.run("string", "join", "seq", n, none, [&](int) { return jmixin::join(text.split()).size(); });
+      suite.run("string", "normalize", "seq", n, none, [&](int) { return text.normalize().size(); });
+      suite.run("string", "dice_coefficient", "seq", n, none, [&](int) { return text.dice_coefficient(other); });
+    }
+
+    if (n <= quadratic/10) {
+      suite.run("string", "levenshtein", "seq", n, none, [&](int) { return text.levenshtein(other); });
+    }
+  }
+
+  return suite.finish();
+}
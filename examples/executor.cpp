@@ -0,0 +1,84 @@
+#include "jmixin/jiterator.h"
+
+#include <chrono>
+#include <iomanip>
+#include <string>
+
+static volatile std::size_t sink;
+
+template<typename Callback>
+double measure(Callback callback)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  callback();
+
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename ExecutionPolicy>
+void run(const std::string &name, ExecutionPolicy &&policy, const jmixin::Iterator<std::vector<std::uint64_t>> &items)
+{
+  auto sort = measure([&]() {
+      sink = items.copy().sort(policy, std::less<>()).size();
+  });
+
+  auto map = measure([&]() {
+      sink = items.map(policy, [](const auto &item) {
+          return item*item + 1;
+      }).size();
+  });
+
+  auto filter = measure([&]() {
+      sink = items.copy().filter(policy, [](const auto &item) {
+          return item % 3 == 0;
+      }).size();
+  });
+
+  auto count = measure([&]() {
+      sink = items.count(policy, [](const auto &item) {
+          return item % 7 == 0;
+      });
+  });
+
+  std::cout << std::setw(24) << std::left << name << std::right << std::fixed << std::setprecision(2)
+    << std::setw(12) << sort << std::setw(12) << map << std::setw(12) << filter << std::setw(12) << count << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc < 2) {
+    std::cout << "usage: " << argv[0] << " <number of items> [workers]" << std::endl;
+
+    return 0;
+  }
+
+  std::size_t size = std::stoul(argv[1]);
+  std::size_t workers = argc > 2 ? std::stoul(argv[2]) : 0;
+
+  jmixin::Iterator<std::vector<std::uint64_t>> items;
+
+  items.generate([seed=std::uint64_t{88172645463325252ull}]() mutable {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+
+      return seed;
+  }, size);
+
+  jmixin::Executor executor(workers);
+
+  std::cout << std::setw(24) << std::left << "policy [ms]" << std::right
+    << std::setw(12) << "sort" << std::setw(12) << "map" << std::setw(12) << "filter" << std::setw(12) << "count" << std::endl;
+
+#ifdef JMIXIN_JITERATOR_PARALLEL
+  run("std::execution::seq", std::execution::seq, items);
+  run("std::execution::par", std::execution::par, items);
+#endif
+
+  for (auto grain : {1024, 16384, 262144}) {
+    run("jmixin::par(" + std::to_string(executor.workers()) + ", " + std::to_string(grain) + ")", jmixin::par(executor, grain), items);
+  }
+
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include "jmixin/jiterator.h"
+#include "jmixin/jpipeline.h"
 #include "jmixin/jstring.h"
 
 #include <sstream>
@@ -57,77 +58,100 @@ std::vector<std::string> mediainfo(const std::string &path)
   return result;
 }
 
-jmixin::Iterator<std::vector<jmedia_t>> parseMediaFiles(const std::vector<std::string> &args)
+jmedia_t parseMedia(std::pair<std::string, std::vector<std::string>> &&probe)
 {
-  jmixin::Iterator<std::vector<jmedia_t>> medias;
+  auto &[arg, info] = probe;
 
-  for (auto &arg : args) {
-    auto info = mediainfo(arg);
+  jmedia_t media;
 
-    if (info.size() == 0) {
-      std::clog << "Unable to parse media file, probably isn't a MPEG-TS" << std::endl;
+  media.filename = arg;
 
-      continue;
-    }
+  auto duration = jmixin::String(*info.begin()).replace_groups("Duration: (..:..:..\\...).*", "$1").trim();
 
-    jmedia_t media;
+  struct tm tm;
 
-    media.filename = arg;
+  if (strptime(duration.c_str(), "%T", &tm)) {
+    media.duration = std::chrono::milliseconds{(tm.tm_hour*3600 + tm.tm_min*60 + tm.tm_sec)*1000};
+  }
 
-    auto duration = jmixin::String(*info.begin()).replace_groups("Duration: (..:..:..\\...).*", "$1").trim();
+  info.erase(info.begin());
 
-    struct tm tm;
+  std::clog << "duration: " << media.duration.count() << "\n" << std::endl;
 
-    if (strptime(duration.c_str(), "%T", &tm)) {
-      media.duration = std::chrono::milliseconds{(tm.tm_hour*3600 + tm.tm_min*60 + tm.tm_sec)*1000};
-    }
+  while (jmixin::String(*info.begin()).starts_with("  Program") == true) {
+    jprogram_t program;
 
-    info.erase(info.begin());
+    program.number = std::atoi(jmixin::String(*info.begin()).replace_groups("Program (.*)", "$1").trim().c_str());
 
-    std::clog << "duration: " << media.duration.count() << "\n" << std::endl;
+    info.erase(info.begin()); // program
 
-    while (jmixin::String(*info.begin()).starts_with("  Program") == true) {
-      jprogram_t program;
+    info.erase(info.begin()); // metadata
 
-      program.number = std::atoi(jmixin::String(*info.begin()).replace_groups("Program (.*)", "$1").trim().c_str());
+    program.name = jmixin::String(*info.begin()).replace_groups("service_name.*: (.*)", "$1").trim();
+  
+    info.erase(info.begin()); // serice_name
 
-      info.erase(info.begin()); // program
+    info.erase(info.begin()); // serice_provider
 
-      info.erase(info.begin()); // metadata
+    std::clog << "program: " << program.number << ": " << program.name << std::endl;
 
-      program.name = jmixin::String(*info.begin()).replace_groups("service_name.*: (.*)", "$1").trim();
-    
-      info.erase(info.begin()); // serice_name
+    while (jmixin::String(*info.begin()).starts_with("    Stream") == true) {
+      auto streamInfo = jmixin::String(*info.begin()).groups("Stream \\#0:([[:d:]]*)\\[([[:alnum:]]*)\\].*?: ([[:alnum:]]*): (.*)");
 
-      info.erase(info.begin()); // serice_provider
+      info.erase(info.begin()); // stream
 
-      std::clog << "program: " << program.number << ": " << program.name << std::endl;
+      if (streamInfo[0].size() == 5) { // 1<match> + 4<sub-groups>
+        jelementary_stream_t stream;
 
-      while (jmixin::String(*info.begin()).starts_with("    Stream") == true) {
-        auto streamInfo = jmixin::String(*info.begin()).groups("Stream \\#0:([[:d:]]*)\\[([[:alnum:]]*)\\].*?: ([[:alnum:]]*): (.*)");
+        stream.index = std::atoi(streamInfo[0][1].trim().c_str());
+        stream.pid = std::atoi(streamInfo[0][2].trim().c_str());
+        stream.type = streamInfo[0][3].trim();
+        stream.description = streamInfo[0][4].trim();
+     
+        program.streams.emplace_back(stream);
 
-        info.erase(info.begin()); // stream
+        std::clog << stream.index << ":" << stream.pid << ":" << stream.type << ": " << stream.description << std::endl;
+      }
+    }
 
-        if (streamInfo[0].size() == 5) { // 1<match> + 4<sub-groups>
-          jelementary_stream_t stream;
+    media.programs.emplace_back(program);
 
-          stream.index = std::atoi(streamInfo[0][1].trim().c_str());
-          stream.pid = std::atoi(streamInfo[0][2].trim().c_str());
-          stream.type = streamInfo[0][3].trim();
-          stream.description = streamInfo[0][4].trim();
-       
-          program.streams.emplace_back(stream);
+    std::cout << std::endl;
+  }
 
-          std::clog << stream.index << ":" << stream.pid << ":" << stream.type << ": " << stream.description << std::endl;
+  return media;
+}
+
+// ffmpeg runs on a few threads while the parse stage works on the reports
+// already read; the probes finish in any order, so the medias are put back
+// in the order of the arguments
+jmixin::Iterator<std::vector<jmedia_t>> parseMediaFiles(const std::vector<std::string> &args)
+{
+  auto pipeline = jmixin::pipeline(args)
+    .map("probe", [](std::string &&arg) {
+        auto info = mediainfo(arg);
+
+        return std::make_pair(std::move(arg), std::move(info));
+    }, 4)
+    .filter("mpegts", [](const auto &probe) {
+        if (probe.second.size() == 0) {
+          std::clog << "Unable to parse media file, probably isn't a MPEG-TS" << std::endl;
+
+          return false;
         }
-      }
 
-      media.programs.emplace_back(program);
+        return true;
+    })
+    .map("parse", parseMedia);
 
-      std::cout << std::endl;
-    }
+  auto medias = pipeline.collect();
+
+  medias.sort_by([&args](const jmedia_t &media) {
+      return std::find(std::begin(args), std::end(args), media.filename) - std::begin(args);
+  });
 
-    medias.emplace_back(media);
+  for (const auto &stage : pipeline.stats()) {
+    std::clog << stage.name << ": " << stage.items << " items, " << stage.throughput() << " items/s, " << stage.stalls << " stalls" << std::endl;
   }
 
   return medias;
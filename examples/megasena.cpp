@@ -1,41 +1,40 @@
 #include "jmixin/jiterator.h"
+#include "jmixin/jlines.h"
 #include "jmixin/jstring.h"
 
-#include <sstream>
+#include <charconv>
 #include <string>
-#include <fstream>
 
 static const std::string gFile {"../examples/megasena.txt"};
 
 std::vector<std::vector<std::size_t>> load_results(const std::string &path)
 {
-  std::ifstream in;
+  std::vector<std::vector<std::size_t>> results;
 
-  in.open(path);
+  try {
+    jmixin::lines(path)
+      .for_each([&results](std::string_view line) {
+        std::vector<std::size_t> values;
 
-  if (!in) {
-    std::clog << "unable to open file '" << gFile << "'" << std::endl;
+        const char *first = line.data();
+        const char *last = line.data() + line.size();
 
-    return {};
-  }
-
-  std::vector<std::vector<std::size_t>> results;
-  std::string line;
+        for (std::size_t i = 0; i < 6; i++) {
+          std::size_t value = 0;
 
-  while (std::getline(in, line)) {
-    std::istringstream is(line);
-
-    std::vector<std::size_t> values;
+          while (first != last and (*first == ' ' or *first == '\t')) {
+            first++;
+          }
 
-    for (std::size_t i = 0; i < 6; i++) {
-      std::size_t value;
+          first = std::from_chars(first, last, value).ptr;
 
-      is >> value;
+          values.push_back(value);
+        }
 
-      values.push_back(value);
-    }
-    
-    results.push_back(values);
+        results.push_back(values);
+      });
+  } catch (const std::runtime_error &) {
+    std::clog << "unable to open file '" << gFile << "'" << std::endl;
   }
 
   return results;
@@ -53,21 +52,13 @@ int main(int argc, char **argv)
 
   auto results = load_results(gFile);
 
-  std::map<std::size_t, std::size_t> freqMaximun;
-
-  jmixin::Iterator(results)
-    .map<std::vector<std::size_t>>([](const std::vector<std::size_t> &item) {
+  auto average = jmixin::Iterator(results)
+    .count_by([](const std::vector<std::size_t> &item) {
         return jmixin::Iterator(item).sum<std::size_t>();
-    }).for_each([&freqMaximun](const auto &item) {
-      freqMaximun[item]++;
-    });
-
-  auto average = jmixin::Iterator(freqMaximun)
-    .map<std::vector<std::pair<std::size_t, std::size_t>>>([](const auto &item) {
-        return item;})
-    .sort([](const auto &item1, const auto &item2) {
-        return item1.second > item2.second;})
-    .take(numberOfAverageResults).for_each([](const auto &item) {
+    })
+    .top_k(numberOfAverageResults, [](const auto &item1, const auto &item2) {
+        return item1.second < item2.second;})
+    .for_each([](const auto &item) {
         std::cout << jmixin::String(std::to_string(item.first)).right(3) << " ";
     }, []{std::cout << "\n:maximun sums: " << std::endl;}, []{std::cout << std::endl;})
     .for_each([](const auto &) {
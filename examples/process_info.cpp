@@ -1,9 +1,9 @@
 #include "jmixin/jiterator.h"
+#include "jmixin/jlines.h"
 #include "jmixin/jstring.h"
 
 #include <sstream>
 #include <string>
-#include <fstream>
 #include <filesystem>
 
 #include <sys/types.h>
@@ -34,26 +34,15 @@ uid_t userid_from_name(const std::string &name)
   return pwd->pw_uid;
 }
 
-std::vector<std::string> read_lines_from_file(const std::string &path)
+jmixin::Iterator<jmixin::Lines> read_lines_from_file(const std::string &path)
 {
-  std::ifstream in;
-
-  in.open(path);
-
-  if (!in) {
+  try {
+    return jmixin::lines(path);
+  } catch (const std::runtime_error &) {
     std::clog << "unable to open file '" << path << "'" << std::endl;
 
     return {};
   }
-
-  std::vector<std::string> results;
-  std::string line;
-
-  while (std::getline(in, line)) {
-    results.push_back(line);
-  }
-
-  return results;
 }
 
 std::vector<std::string> load_pids_from_proc()
@@ -87,7 +76,7 @@ int main(int argc, char **argv)
 
       jmixin::Iterator(read_lines_from_file(pid_path + "/status"))
         .for_each([&process](const auto &item) {
-          std::istringstream is(item);
+          std::istringstream is {std::string(item)};
           std::string str;
 
           if (jmixin::String(item).lower_case().starts_with("name:") == true) {
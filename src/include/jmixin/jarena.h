@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace jmixin {
+
+  // Allocators that own the memory their elements point into, such as the
+  // MappedAllocator of jmixin::lines(): whatever is built from such a
+  // container must carry the allocator along, or its elements dangle.
+  template<typename Allocator>
+    inline constexpr bool is_owning_allocator_v = false;
+
+  template<typename Result, typename Source, typename ...Args>
+    inline constexpr bool takes_allocator_v = requires (const Source &source) {
+      typename Result::allocator_type;
+      requires std::is_constructible_v<typename Result::allocator_type, decltype(source.get_allocator())>;
+      requires std::is_constructible_v<Result, Args..., const typename Result::allocator_type &>;
+    };
+
+  // Builds a Result from args using the allocator of source (rebound to the
+  // Result elements), so the intermediates created from a std::pmr container
+  // stay in its memory resource. Results that can not take that allocator
+  // are built with their default one, unless they would hold the elements
+  // of an owning allocator without it.
+  template<typename Result, typename Source, typename ...Args>
+    Result make_like(const Source &source, Args &&...args)
+    {
+      if constexpr (takes_allocator_v<Result, Source, Args...>) {
+        return Result(std::forward<Args>(args)..., typename Result::allocator_type(source.get_allocator()));
+      } else {
+        if constexpr (requires { source.get_allocator(); typename Source::value_type; typename Result::value_type; }) {
+          static_assert(is_owning_allocator_v<std::remove_cvref_t<decltype(source.get_allocator())>> == false or std::is_same_v<typename Source::value_type, typename Result::value_type> == false,
+              "The elements point into memory owned by the allocator of the source, which the result can not take");
+        }
+
+        return Result(std::forward<Args>(args)...);
+      }
+    }
+
+  // A monotonic memory resource for request scoped pipelines: allocations
+  // bump a pointer in blocks taken from upstream (or from an initial buffer),
+  // deallocations are no-ops and everything is freed at once by release()
+  // or by the destructor. It is not thread safe, so with parallel policies
+  // the elements must not allocate (the containers themselves are always
+  // resized by the calling thread).
+  class Arena : public std::pmr::memory_resource {
+
+    public:
+      static constexpr std::size_t default_capacity = 64*1024;
+
+      explicit Arena(std::size_t capacity = default_capacity, std::pmr::memory_resource *upstream = std::pmr::get_default_resource()):
+        _resource(capacity, upstream)
+      {
+      }
+
+      explicit Arena(std::span<std::byte> buffer, std::pmr::memory_resource *upstream = std::pmr::get_default_resource()):
+        _resource(buffer.data(), buffer.size(), upstream)
+      {
+      }
+
+      Arena(const Arena &) = delete;
+
+      Arena & operator=(const Arena &) = delete;
+
+      template<typename T = std::byte>
+        std::pmr::polymorphic_allocator<T> allocator()
+        {
+          return std::pmr::polymorphic_allocator<T>(this);
+        }
+
+      // bytes handed out since the construction or the last release()
+      std::size_t allocated() const
+      {
+        return _allocated;
+      }
+
+      // Frees every allocation at once; containers still using the arena
+      // must not be touched after it.
+      void release()
+      {
+        _resource.release();
+
+        _allocated = 0;
+      }
+
+    private:
+      std::pmr::monotonic_buffer_resource _resource;
+      std::size_t _allocated {0};
+
+      void * do_allocate(std::size_t bytes, std::size_t alignment) override
+      {
+        void *pointer = _resource.allocate(bytes, alignment);
+
+        _allocated += bytes;
+
+        return pointer;
+      }
+
+      void do_deallocate(void *, std::size_t, std::size_t) override
+      {
+      }
+
+      bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+      {
+        return this == &other;
+      }
+
+  };
+
+}
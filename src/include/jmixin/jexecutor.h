@@ -0,0 +1,308 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace jmixin {
+
+  // A fixed size work-stealing thread pool. Each worker owns a deque of
+  // ranges: it splits its range in halves until the grain size is reached,
+  // keeps working on the left half and pushes the right half, which idle
+  // workers steal from the front. The thread calling parallel_for helps
+  // until all of its work is done.
+  class Executor {
+
+    private:
+      struct Job {
+        virtual ~Job() = default;
+
+        virtual void run(std::size_t begin, std::size_t end) = 0;
+
+        std::size_t grain {1};
+        std::atomic<std::size_t> remaining {0};
+        std::mutex mutex;
+        std::exception_ptr error;
+      };
+
+      struct Task {
+        Job *job {nullptr};
+        std::size_t begin {0};
+        std::size_t end {0};
+      };
+
+      struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+      };
+
+    public:
+      static constexpr std::size_t default_grain = 4096;
+
+      explicit Executor(std::size_t workers = 0, bool pinned = false)
+      {
+        if (workers == 0) {
+          workers = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        // one queue per worker plus a shared one for external callers
+        for (std::size_t i=0; i<workers + 1; i++) {
+          _queues.push_back(std::make_unique<Queue>());
+        }
+
+        for (std::size_t i=0; i<workers; i++) {
+          _threads.emplace_back([this, i]() {
+              work(i);
+          });
+
+#ifdef __linux__
+          if (pinned == true) {
+            cpu_set_t set;
+
+            CPU_ZERO(&set);
+            CPU_SET(i % std::max<std::size_t>(1, std::thread::hardware_concurrency()), &set);
+
+            pthread_setaffinity_np(_threads.back().native_handle(), sizeof(set), &set);
+          }
+#else
+          (void)pinned;
+#endif
+        }
+      }
+
+      Executor(const Executor &) = delete;
+
+      Executor & operator=(const Executor &) = delete;
+
+      ~Executor()
+      {
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+
+          _stop = true;
+        }
+
+        _wakeup.notify_all();
+
+        for (auto &thread : _threads) {
+          thread.join();
+        }
+      }
+
+      std::size_t workers() const
+      {
+        return _threads.size();
+      }
+
+      // Calls function(begin, end) over disjoint ranges covering [0, n), none
+      // of them larger than grain, and returns when all of them are done. The
+      // first exception thrown by function is rethrown here.
+      template<typename Function>
+        void parallel_for(std::size_t n, std::size_t grain, Function function)
+        {
+          struct FunctionJob : public Job {
+            FunctionJob(Function &function):
+              function(function)
+            {
+            }
+
+            void run(std::size_t begin, std::size_t end) override
+            {
+              function(begin, end);
+            }
+
+            Function &function;
+          };
+
+          if (n == 0) {
+            return;
+          }
+
+          FunctionJob job(function);
+
+          job.grain = std::max<std::size_t>(1, grain);
+          job.remaining = n;
+
+          std::size_t index = current();
+
+          push(index, {&job, 0, n});
+
+          while (job.remaining.load(std::memory_order_acquire) != 0) {
+            Task task;
+
+            if (pop(index, task) == true or steal(index, task) == true) {
+              execute(index, task);
+            } else {
+              std::this_thread::yield();
+            }
+          }
+
+          if (job.error) {
+            std::rethrow_exception(job.error);
+          }
+        }
+
+    private:
+      std::vector<std::unique_ptr<Queue>> _queues;
+      std::vector<std::thread> _threads;
+      std::atomic<std::size_t> _pending {0};
+      std::mutex _mutex;
+      std::condition_variable _wakeup;
+      bool _stop {false};
+
+      static Executor * & owner()
+      {
+        static thread_local Executor *executor = nullptr;
+
+        return executor;
+      }
+
+      static std::size_t & worker()
+      {
+        static thread_local std::size_t index = 0;
+
+        return index;
+      }
+
+      std::size_t current() const
+      {
+        if (owner() == this) {
+          return worker();
+        }
+
+        return _threads.size();
+      }
+
+      void push(std::size_t index, Task task)
+      {
+        {
+          std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+
+          _queues[index]->tasks.push_back(task);
+        }
+
+        _pending.fetch_add(1, std::memory_order_release);
+
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+        }
+
+        _wakeup.notify_one();
+      }
+
+      bool pop(std::size_t index, Task &task)
+      {
+        std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+
+        if (_queues[index]->tasks.empty() == true) {
+          return false;
+        }
+
+        task = _queues[index]->tasks.back();
+
+        _queues[index]->tasks.pop_back();
+        _pending.fetch_sub(1, std::memory_order_relaxed);
+
+        return true;
+      }
+
+      bool steal(std::size_t index, Task &task)
+      {
+        for (std::size_t i=1; i<_queues.size(); i++) {
+          auto &queue = *_queues[(index + i) % _queues.size()];
+
+          std::lock_guard<std::mutex> lock(queue.mutex);
+
+          if (queue.tasks.empty() == false) {
+            task = queue.tasks.front();
+
+            queue.tasks.pop_front();
+            _pending.fetch_sub(1, std::memory_order_relaxed);
+
+            return true;
+          }
+        }
+
+        return false;
+      }
+
+      void execute(std::size_t index, Task task)
+      {
+        Job *job = task.job;
+
+        while (task.end - task.begin > job->grain) {
+          std::size_t middle = task.begin + (task.end - task.begin)/2;
+
+          push(index, {job, middle, task.end});
+
+          task.end = middle;
+        }
+
+        try {
+          job->run(task.begin, task.end);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(job->mutex);
+
+          if (!job->error) {
+            job->error = std::current_exception();
+          }
+        }
+
+        // the job lives in the caller stack and may be gone after this
+        job->remaining.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+      }
+
+      void work(std::size_t index)
+      {
+        owner() = this;
+        worker() = index;
+
+        while (true) {
+          Task task;
+
+          if (pop(index, task) == true or steal(index, task) == true) {
+            execute(index, task);
+
+            continue;
+          }
+
+          std::unique_lock<std::mutex> lock(_mutex);
+
+          _wakeup.wait(lock, [this]() {
+              return _stop == true or _pending.load(std::memory_order_acquire) > 0;
+          });
+
+          if (_stop == true and _pending.load(std::memory_order_acquire) == 0) {
+            return;
+          }
+        }
+      }
+
+  };
+
+  struct ExecutorPolicy {
+    Executor *executor;
+    std::size_t grain;
+  };
+
+  inline ExecutorPolicy par(Executor &executor, std::size_t grain = Executor::default_grain)
+  {
+    return {&executor, grain};
+  }
+
+  template<typename ExecutionPolicy>
+    inline constexpr bool is_executor_policy_v = std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, ExecutorPolicy>;
+
+}
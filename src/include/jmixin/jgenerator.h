@@ -0,0 +1,264 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "jlazy.h"
+
+namespace jmixin {
+
+  // A coroutine that yields a sequence of T on demand, so sequences can be
+  // unbounded: nothing runs until an item is asked for and the frame is
+  // freed as soon as the generator goes away. It is an input range of
+  // const T & and a source for the lazy pipeline through lazy().
+  template<typename T>
+    class generator {
+
+      public:
+        using value_type = std::remove_cvref_t<T>;
+
+        struct promise_type {
+          const value_type *value {nullptr};
+          std::exception_ptr error;
+
+          generator get_return_object()
+          {
+            return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+          }
+
+          std::suspend_always initial_suspend() noexcept
+          {
+            return {};
+          }
+
+          std::suspend_always final_suspend() noexcept
+          {
+            return {};
+          }
+
+          // the operand of co_yield lives until the coroutine is resumed
+          std::suspend_always yield_value(const value_type &item) noexcept
+          {
+            value = std::addressof(item);
+
+            return {};
+          }
+
+          void return_void()
+          {
+          }
+
+          void unhandled_exception()
+          {
+            error = std::current_exception();
+          }
+
+          template<typename Awaitable>
+            void await_transform(Awaitable &&) = delete;
+        };
+
+        class iterator {
+
+          public:
+            using value_type = generator::value_type;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            explicit iterator(std::coroutine_handle<promise_type> handle):
+              _handle(handle)
+            {
+            }
+
+            const value_type & operator*() const
+            {
+              return *_handle.promise().value;
+            }
+
+            iterator & operator++()
+            {
+              resume(_handle);
+
+              return *this;
+            }
+
+            void operator++(int)
+            {
+              ++*this;
+            }
+
+            bool operator==(std::default_sentinel_t) const
+            {
+              return _handle == nullptr or _handle.done() == true;
+            }
+
+          private:
+            std::coroutine_handle<promise_type> _handle;
+
+        };
+
+        generator(generator &&other) noexcept:
+          _handle(std::exchange(other._handle, nullptr)), _started(other._started)
+        {
+        }
+
+        generator & operator=(generator &&other) noexcept
+        {
+          if (this != &other) {
+            if (_handle) {
+              _handle.destroy();
+            }
+
+            _handle = std::exchange(other._handle, nullptr);
+            _started = other._started;
+          }
+
+          return *this;
+        }
+
+        generator(const generator &) = delete;
+
+        generator & operator=(const generator &) = delete;
+
+        ~generator()
+        {
+          if (_handle) {
+            _handle.destroy();
+          }
+        }
+
+        // A generator can be iterated only once.
+        iterator begin()
+        {
+          if (_handle and _started == false) {
+            _started = true;
+
+            resume(_handle);
+          }
+
+          return iterator(_handle);
+        }
+
+        std::default_sentinel_t end() const
+        {
+          return {};
+        }
+
+        auto lazy() &&
+        {
+          return jmixin::lazy<value_type>([items=std::move(*this)](auto &sink) mutable {
+              for (const auto &item : items) {
+                if (sink(item) == false) {
+                  return;
+                }
+              }
+          });
+        }
+
+      private:
+        std::coroutine_handle<promise_type> _handle;
+        bool _started {false};
+
+        explicit generator(std::coroutine_handle<promise_type> handle):
+          _handle(handle)
+        {
+        }
+
+        static void resume(std::coroutine_handle<promise_type> handle)
+        {
+          handle.resume();
+
+          if (handle.promise().error) {
+            std::rethrow_exception(std::exchange(handle.promise().error, nullptr));
+          }
+        }
+
+    };
+
+  // start, start + 1, ... without end.
+  template<typename T>
+    generator<T> iota(T start)
+    {
+      for (;; ++start) {
+        co_yield start;
+      }
+    }
+
+  // start, start + 1, ... while lower than stop.
+  template<typename T>
+    generator<T> iota(T start, T stop)
+    {
+      for (; start < stop; ++start) {
+        co_yield start;
+      }
+    }
+
+  template<typename T>
+    generator<T> repeat(T value)
+    {
+      while (true) {
+        co_yield value;
+      }
+    }
+
+  template<typename T>
+    generator<T> repeat(T value, std::size_t n)
+    {
+      for (std::size_t i=0; i<n; i++) {
+        co_yield value;
+      }
+    }
+
+  namespace detail {
+
+    template<typename T>
+      struct unwrap_optional {
+        using type = T;
+      };
+
+    template<typename T>
+      struct unwrap_optional<std::optional<T>> {
+        using type = T;
+      };
+
+  }
+
+  // Yields function() without end, or while it returns a value when it
+  // returns an std::optional.
+  template<typename Function>
+    generator<typename detail::unwrap_optional<std::decay_t<std::invoke_result_t<Function &>>>::type> from_function(Function function)
+    {
+      using Result = std::decay_t<std::invoke_result_t<Function &>>;
+
+      if constexpr (std::is_same_v<Result, std::optional<typename detail::unwrap_optional<Result>::type>>) {
+        for (auto value = function(); value.has_value() == true; value = function()) {
+          co_yield *value;
+        }
+      } else {
+        while (true) {
+          co_yield function();
+        }
+      }
+    }
+
+  // Reads values of T with operator>> until the stream fails; the stream
+  // must outlive the generator.
+  template<typename T = std::string>
+    generator<T> from_istream(std::istream &in)
+    {
+      T value;
+
+      while (in >> value) {
+        co_yield value;
+      }
+    }
+
+}
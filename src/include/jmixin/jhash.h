@@ -0,0 +1,624 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "jarena.h"
+#include "jparallel.h"
+
+namespace jmixin {
+
+  // An open addressing (linear probing) hash map that keeps its entries in a
+  // dense vector, in insertion order; the probe table only stores indexes in
+  // that vector. Entries can not be erased, it is meant for aggregations.
+  template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+    class FlatHashMap {
+
+      public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        explicit FlatHashMap(std::size_t capacity = 0, Hash hash = Hash(), Equal equal = Equal()):
+          _hash(std::move(hash)), _equal(std::move(equal))
+        {
+          reserve(capacity);
+        }
+
+        template<typename ...Args>
+          std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args)
+          {
+            if ((_entries.size() + 1)*4 > _slots.size()*3) {
+              rehash(std::max<std::size_t>(16, 2*_slots.size()));
+            }
+
+            std::size_t mask = _slots.size() - 1;
+
+            for (std::size_t i=position(key); ; i=(i + 1) & mask) {
+              if (_slots[i] == npos) {
+                _slots[i] = _entries.size();
+
+                _entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+
+                return {std::prev(std::end(_entries)), true};
+              }
+
+              if (_equal(_entries[_slots[i]].first, key) == true) {
+                return {std::begin(_entries) + _slots[i], false};
+              }
+            }
+          }
+
+        Value & operator[](const Key &key)
+        {
+          return try_emplace(key).first->second;
+        }
+
+        iterator find(const Key &key)
+        {
+          return std::begin(_entries) + index(key);
+        }
+
+        const_iterator find(const Key &key) const
+        {
+          return std::begin(_entries) + index(key);
+        }
+
+        bool contains(const Key &key) const
+        {
+          return index(key) != _entries.size();
+        }
+
+        void reserve(std::size_t n)
+        {
+          _entries.reserve(n);
+
+          if (n*4 > _slots.size()*3) {
+            rehash(std::bit_ceil(std::max<std::size_t>(16, n*4/3 + 1)));
+          }
+        }
+
+        void clear()
+        {
+          _entries.clear();
+
+          std::fill(std::begin(_slots), std::end(_slots), npos);
+        }
+
+        std::size_t size() const
+        {
+          return _entries.size();
+        }
+
+        bool empty() const
+        {
+          return _entries.empty();
+        }
+
+        iterator begin()
+        {
+          return std::begin(_entries);
+        }
+
+        iterator end()
+        {
+          return std::end(_entries);
+        }
+
+        const_iterator begin() const
+        {
+          return std::begin(_entries);
+        }
+
+        const_iterator end() const
+        {
+          return std::end(_entries);
+        }
+
+        std::vector<value_type> entries() &&
+        {
+          return std::move(_entries);
+        }
+
+      private:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        std::vector<value_type> _entries;
+        std::vector<std::size_t> _slots;
+        std::size_t _shift {64};
+        [[no_unique_address]] Hash _hash;
+        [[no_unique_address]] Equal _equal;
+
+        // fibonacci hashing spreads the identity hashes of integers
+        std::size_t position(const Key &key) const
+        {
+          return static_cast<std::size_t>((static_cast<std::uint64_t>(_hash(key))*0x9e3779b97f4a7c15ull) >> _shift);
+        }
+
+        std::size_t index(const Key &key) const
+        {
+          if (_slots.empty() == true) {
+            return _entries.size();
+          }
+
+          std::size_t mask = _slots.size() - 1;
+
+          for (std::size_t i=position(key); _slots[i]!=npos; i=(i + 1) & mask) {
+            if (_equal(_entries[_slots[i]].first, key) == true) {
+              return _slots[i];
+            }
+          }
+
+          return _entries.size();
+        }
+
+        void rehash(std::size_t n)
+        {
+          _slots.assign(n, npos);
+          _shift = 64 - std::countr_zero(n);
+
+          std::size_t mask = n - 1;
+
+          for (std::size_t j=0; j<_entries.size(); j++) {
+            std::size_t i = position(_entries[j].first);
+
+            while (_slots[i] != npos) {
+              i = (i + 1) & mask;
+            }
+
+            _slots[i] = j;
+          }
+        }
+
+    };
+
+  // The same interface as FlatHashMap for integer keys known to be in
+  // [min, max]: the key itself is the slot.
+  template<typename Key, typename Value>
+    class DenseMap {
+
+      public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+        using iterator = typename std::vector<value_type>::iterator;
+        using const_iterator = typename std::vector<value_type>::const_iterator;
+
+        DenseMap(Key min, Key max):
+          _min(min), _slots(offset(max, min) + 1, npos)
+        {
+        }
+
+        template<typename ...Args>
+          std::pair<iterator, bool> try_emplace(const Key &key, Args &&...args)
+          {
+            auto &slot = _slots[offset(key, _min)];
+
+            if (slot != npos) {
+              return {std::begin(_entries) + slot, false};
+            }
+
+            slot = _entries.size();
+
+            _entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+
+            return {std::prev(std::end(_entries)), true};
+          }
+
+        Value & operator[](const Key &key)
+        {
+          return try_emplace(key).first->second;
+        }
+
+        std::size_t size() const
+        {
+          return _entries.size();
+        }
+
+        iterator begin()
+        {
+          return std::begin(_entries);
+        }
+
+        iterator end()
+        {
+          return std::end(_entries);
+        }
+
+        std::vector<value_type> entries() &&
+        {
+          return std::move(_entries);
+        }
+
+        static std::size_t offset(Key key, Key min)
+        {
+          using Unsigned = std::make_unsigned_t<Key>;
+
+          return static_cast<std::size_t>(static_cast<Unsigned>(key) - static_cast<Unsigned>(min));
+        }
+
+      private:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        Key _min;
+        std::vector<std::size_t> _slots;
+        std::vector<value_type> _entries;
+
+    };
+
+  // An open addressing hash set of the distinct keys inserted, kept in
+  // insertion order; the index of a key is its position in that order. The
+  // slots hold the hash of the key next to its index, so a probe rejects
+  // the other keys without touching them and a rehash never hashes again.
+  template<typename Key, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+    class FlatHashSet {
+
+      public:
+        using key_type = Key;
+        using value_type = Key;
+        using iterator = typename std::vector<Key>::const_iterator;
+        using const_iterator = typename std::vector<Key>::const_iterator;
+
+        explicit FlatHashSet(std::size_t capacity = 0, Hash hash = Hash(), Equal equal = Equal()):
+          _hash(std::move(hash)), _equal(std::move(equal))
+        {
+          reserve(capacity);
+        }
+
+        // The index of key and whether it was inserted.
+        std::pair<std::size_t, bool> insert(const Key &key)
+        {
+          if ((_keys.size() + 1)*4 > _slots.size()*3) {
+            rehash(std::max<std::size_t>(16, 2*_slots.size()));
+          }
+
+          std::size_t mask = _slots.size() - 1;
+          std::size_t hash = _hash(key);
+
+          for (std::size_t i=position(hash); ; i=(i + 1) & mask) {
+            if (_slots[i].index == npos) {
+              _slots[i] = {_keys.size(), hash};
+
+              _keys.push_back(key);
+
+              return {_keys.size() - 1, true};
+            }
+
+            if (matches(_slots[i], hash, key) == true) {
+              return {_slots[i].index, false};
+            }
+          }
+        }
+
+        // The index of key, or size() when it is not in the set.
+        std::size_t index(const Key &key) const
+        {
+          if (_slots.empty() == true) {
+            return _keys.size();
+          }
+
+          std::size_t mask = _slots.size() - 1;
+          std::size_t hash = _hash(key);
+
+          for (std::size_t i=position(hash); _slots[i].index!=npos; i=(i + 1) & mask) {
+            if (matches(_slots[i], hash, key) == true) {
+              return _slots[i].index;
+            }
+          }
+
+          return _keys.size();
+        }
+
+        bool contains(const Key &key) const
+        {
+          return index(key) != _keys.size();
+        }
+
+        void reserve(std::size_t n)
+        {
+          _keys.reserve(n);
+
+          if (n*4 > _slots.size()*3) {
+            rehash(std::bit_ceil(std::max<std::size_t>(16, n*4/3 + 1)));
+          }
+        }
+
+        std::size_t size() const
+        {
+          return _keys.size();
+        }
+
+        bool empty() const
+        {
+          return _keys.empty();
+        }
+
+        const_iterator begin() const
+        {
+          return std::begin(_keys);
+        }
+
+        const_iterator end() const
+        {
+          return std::end(_keys);
+        }
+
+      private:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        struct Slot {
+          std::size_t index {npos};
+          std::size_t hash {0};
+        };
+
+        std::vector<Key> _keys;
+        std::vector<Slot> _slots;
+        std::size_t _shift {64};
+        [[no_unique_address]] Hash _hash;
+        [[no_unique_address]] Equal _equal;
+
+        std::size_t position(std::size_t hash) const
+        {
+          return static_cast<std::size_t>((static_cast<std::uint64_t>(hash)*0x9e3779b97f4a7c15ull) >> _shift);
+        }
+
+        bool matches(const Slot &slot, std::size_t hash, const Key &key) const
+        {
+          return slot.hash == hash and _equal(_keys[slot.index], key) == true;
+        }
+
+        void rehash(std::size_t n)
+        {
+          std::vector<Slot> slots(n);
+
+          std::swap(slots, _slots);
+
+          _shift = 64 - std::countr_zero(n);
+
+          std::size_t mask = n - 1;
+
+          for (const Slot &slot : slots) {
+            if (slot.index == npos) {
+              continue;
+            }
+
+            std::size_t i = position(slot.hash);
+
+            while (_slots[i].index != npos) {
+              i = (i + 1) & mask;
+            }
+
+            _slots[i] = slot;
+          }
+        }
+
+    };
+
+  // The distinct items of range, in the order they first appear.
+  template<typename Key, typename Range>
+    FlatHashSet<Key> make_set(const Range &range)
+    {
+      FlatHashSet<Key> result(std::size(range));
+
+      for (const auto &item : range) {
+        result.insert(item);
+      }
+
+      return result;
+    }
+
+  // Converts to a copy of value, allocator included, only when a table
+  // actually inserts a new key.
+  template<typename Value>
+    struct Seed {
+      const Value &value;
+
+      operator Value() const
+      {
+        return make_like<Value>(value, value);
+      }
+    };
+
+  template<typename Key>
+    inline constexpr bool is_dense_key_v = std::is_integral_v<Key> and not std::is_same_v<Key, bool>;
+
+  // Key ranges up to this many times the number of items use a DenseMap,
+  // so its slots never cost much more than the items themselves.
+  static constexpr std::size_t dense_ratio = 4;
+
+  template<typename InputIterator, typename KeyFunction>
+    using key_result_t = std::decay_t<std::invoke_result_t<KeyFunction &, std::iter_reference_t<InputIterator>>>;
+
+  template<typename KeyIterator>
+    std::optional<std::pair<std::iter_value_t<KeyIterator>, std::iter_value_t<KeyIterator>>> key_bounds(KeyIterator first, KeyIterator last)
+    {
+      if (first == last) {
+        return {};
+      }
+
+      auto [min, max] = std::minmax_element(first, last);
+
+      return std::pair{*min, *max};
+    }
+
+  template<typename Key>
+    bool is_dense_range(const std::optional<std::pair<Key, Key>> &bounds, std::size_t n)
+    {
+      return bounds and DenseMap<Key, int>::offset(bounds->second, bounds->first) < dense_ratio*n;
+    }
+
+  // Groups the items by key(item): fold(value, item) updates the value of
+  // the group, that starts as initial. The groups are returned in the order
+  // their keys first appear.
+  template<typename InputIterator, typename KeyFunction, typename Value, typename Fold>
+    std::vector<std::pair<key_result_t<InputIterator, KeyFunction>, Value>> aggregate(InputIterator first, InputIterator last, KeyFunction key, const Value &initial, Fold fold)
+    {
+      using Key = key_result_t<InputIterator, KeyFunction>;
+
+      auto run = [&](auto table, auto &&key_of) {
+        for (auto i=first; i!=last; ++i) {
+          fold(table.try_emplace(key_of(*i), Seed<Value>{initial}).first->second, *i);
+        }
+
+        return std::move(table).entries();
+      };
+
+      if constexpr (is_dense_key_v<Key>) {
+        // the keys are computed once for the bounds and then replayed
+        std::vector<Key> keys;
+
+        keys.reserve(std::distance(first, last));
+
+        for (auto i=first; i!=last; ++i) {
+          keys.push_back(key(*i));
+        }
+
+        auto bounds = key_bounds(std::begin(keys), std::end(keys));
+        auto cached = [next=std::begin(keys)](const auto &) mutable {
+          return *next++;
+        };
+
+        if (is_dense_range(bounds, keys.size()) == true) {
+          return run(DenseMap<Key, Value>(bounds->first, bounds->second), cached);
+        }
+
+        return run(FlatHashMap<Key, Value>(), cached);
+      } else {
+        return run(FlatHashMap<Key, Value>(), key);
+      }
+    }
+
+  namespace parallel {
+
+    // Every chunk aggregates in its own table, then the tables are merged in
+    // chunk order with merge(value, partial), which keeps the order of the
+    // keys. The number of chunks is bounded by the concurrency of the policy.
+    template<typename ExecutionPolicy, typename InputIterator, typename KeyFunction, typename Value, typename Fold, typename Merge>
+      std::vector<std::pair<key_result_t<InputIterator, KeyFunction>, Value>> aggregate(ExecutionPolicy &&policy, InputIterator first, InputIterator last, KeyFunction key, const Value &initial, Fold fold, Merge merge)
+      {
+        using Key = key_result_t<InputIterator, KeyFunction>;
+
+        if constexpr (not std::random_access_iterator<InputIterator>) {
+          return jmixin::aggregate(first, last, key, initial, fold);
+        } else {
+          std::size_t n = std::distance(first, last);
+          std::size_t count = std::min(chunks(policy, n), concurrency(policy));
+
+          auto run = [&](auto make, auto &&key_at) {
+            std::vector<decltype(make())> tables;
+
+            for (std::size_t i=0; i<count; i++) {
+              tables.push_back(make());
+            }
+
+            for_each_chunk(policy, n, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                auto &table = tables[chunk];
+
+                for (std::size_t i=begin; i<end; i++) {
+                  fold(table.try_emplace(key_at(i), Seed<Value>{initial}).first->second, first[i]);
+                }
+            });
+
+            auto result = make();
+
+            for (auto &table : tables) {
+              for (auto &[k, value] : table) {
+                auto [i, inserted] = result.try_emplace(k, std::move(value));
+
+                if (inserted == false) {
+                  merge(i->second, std::move(value));
+                }
+              }
+            }
+
+            return std::move(result).entries();
+          };
+
+          if constexpr (is_dense_key_v<Key>) {
+            // the keys are computed once for the bounds and then replayed
+            std::vector<Key> keys(n);
+            std::vector<std::optional<std::pair<Key, Key>>> partial(count);
+
+            for_each_chunk(policy, n, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                auto chunk_key = key;
+
+                for (std::size_t i=begin; i<end; i++) {
+                  keys[i] = chunk_key(first[i]);
+                }
+
+                partial[chunk] = key_bounds(std::begin(keys) + begin, std::begin(keys) + end);
+            });
+
+            std::optional<std::pair<Key, Key>> bounds;
+
+            for (auto &item : partial) {
+              if (item and bounds) {
+                bounds->first = std::min(bounds->first, item->first);
+                bounds->second = std::max(bounds->second, item->second);
+              } else if (item) {
+                bounds = item;
+              }
+            }
+
+            auto cached = [&keys](std::size_t i) {
+              return keys[i];
+            };
+
+            // every chunk has its own table, so each one gets its share of n
+            if (is_dense_range(bounds, n/std::max<std::size_t>(1, count)) == true) {
+              return run([&bounds]() {
+                  return DenseMap<Key, Value>(bounds->first, bounds->second);
+              }, cached);
+            }
+
+            return run([]() {
+                return FlatHashMap<Key, Value>();
+            }, cached);
+          } else {
+            return run([]() {
+                return FlatHashMap<Key, Value>();
+            }, [&](std::size_t i) {
+                return key(first[i]);
+            });
+          }
+        }
+      }
+
+    // Calls f(item) for every item of range, from many threads for random
+    // access ranges; f must be safe to call concurrently.
+    template<typename ExecutionPolicy, typename Range, typename Function>
+      void probe(ExecutionPolicy &&policy, const Range &range, Function f)
+      {
+        if constexpr (std::ranges::random_access_range<const Range>) {
+          std::size_t n = std::size(range);
+          auto first = std::ranges::begin(range);
+
+          for_each_chunk(policy, n, chunks(policy, n), [&](std::size_t, std::size_t begin, std::size_t end) {
+              for (std::size_t i=begin; i<end; i++) {
+                f(first[i]);
+              }
+          });
+        } else {
+          (void)policy;
+
+          for (const auto &item : range) {
+            f(item);
+          }
+        }
+      }
+
+  }
+
+}
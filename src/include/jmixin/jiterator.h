@@ -7,100 +7,307 @@
 #include <optional>
 #include <numeric>
 #include <random>
-
-#ifdef JMIXIN_JITERATOR_PARALLEL
-#include <execution>
-#endif
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <cassert>
+
+#include "jarena.h"
+#include "jhash.h"
+#include "jlazy.h"
+#include "jmerge.h"
+#include "jparallel.h"
+#include "jrandom.h"
+#include "jsimd.h"
+#include "jsort.h"
+#include "jtrace.h"
 
 namespace jmixin {
 
+  template<typename Container, typename Compare = std::less<>>
+    class SortedIterator;
+
   template<typename Container>
     class Iterator : public Container {
 
       public:
         Iterator() = default;
 
+        // std::pmr containers do not propagate their resource on copies, but
+        // a wrapped copy keeps it so the whole pipeline shares the same arena
         Iterator(const Container &container):
-          Container(container)
+          Container(make_like<Container>(container, container))
+        {
+        }
+
+        Iterator(Container &&container):
+          Container(std::move(container))
         {
         }
 
         Iterator<Container> copy() const
         {
-          Container result;
+          JMIXIN_TRACE("copy");
+
+          Container result = make_like<Container>(*this);
 
           std::copy(std::begin(*this), std::end(*this), std::inserter(result, std::end(result)));
 
-          return Iterator<Container>(result);
+          JMIXIN_TRACE_OUTPUT(result);
+
+          return Iterator<Container>(std::move(result));
         }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename ExecutionPolicy>
           Iterator<Container> copy(ExecutionPolicy &&policy) const
           {
-            Container result;
+            JMIXIN_TRACE("copy(par)");
 
-            std::copy(policy, std::begin(*this), std::end(*this), std::inserter(result, std::end(result)));
+            Container result = make_like<Container>(*this);
 
-            return Iterator<Container>(result);
+            parallel::copy(policy, std::begin(*this), std::end(*this), result);
+
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<Container>(std::move(result));
           }
-#endif
 
         Iterator<Container> copy_n(std::size_t n) const
         {
-          Container result;
+          JMIXIN_TRACE("copy_n");
+
+          Container result = make_like<Container>(*this);
 
           std::copy_n(std::begin(*this), n, std::inserter(result, std::end(result)));
 
-          return Iterator<Container>(result);
+          JMIXIN_TRACE_OUTPUT(result);
+
+          return Iterator<Container>(std::move(result));
         }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename ExecutionPolicy>
           Iterator<Container> copy_n(ExecutionPolicy &&policy, std::size_t n) const
           {
-            Container result;
+            JMIXIN_TRACE("copy_n(par)");
+
+            Container result = make_like<Container>(*this);
 
-            std::copy_n(policy, std::begin(*this), n, std::inserter(result, std::end(result)));
+            parallel::copy(policy, std::begin(*this), std::next(std::begin(*this), n), result);
 
-            return Iterator<Container>(result);
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<Container>(std::move(result));
           }
-#endif
+
+        // The containers collected from the view take an owning allocator of
+        // this one, so they keep alive what the items point into.
+        auto lazy() const &
+        {
+          return jmixin::lazy<typename Container::value_type>([this](auto &sink) {
+              for (const auto &item : *this) {
+                if (sink(item) == false) {
+                  break;
+                }
+              }
+          }, lazy_allocator());
+        }
+
+        auto lazy() &&
+        {
+          auto allocator = lazy_allocator();
+
+          return jmixin::lazy<typename Container::value_type>([container=Container(std::move(*this))](auto &sink) {
+              for (const auto &item : container) {
+                if (sink(item) == false) {
+                  break;
+                }
+              }
+          }, std::move(allocator));
+        }
+
+        // Lazy views that yield (index, item) and (item, items...) tuples holding
+        // references to the items, so nothing is copied. The zipped containers
+        // must have the same size and outlive the view, so temporaries are
+        // rejected.
+        auto enumerate_view() const &
+        {
+          return jmixin::lazy<std::tuple<std::size_t, std::ranges::range_reference_t<const Container>>>([this](auto &sink) {
+              zip_items(sink, std::size(*this), std::views::iota(std::size_t{0}), *this);
+          });
+        }
+
+        void enumerate_view() && = delete;
+
+        template<typename ...Containers>
+          auto zip_view(const Containers &...others) const &
+          {
+            if (((std::size(others) != std::size(*this)) or ...)) {
+              throw std::runtime_error("All containers must have the same size");
+            }
+
+            return jmixin::lazy<std::tuple<std::ranges::range_reference_t<const Container>, std::ranges::range_reference_t<const Containers>...>>([this, &others...](auto &sink) {
+                zip_items(sink, std::size(*this), *this, others...);
+            });
+          }
+
+        template<typename ...Containers>
+          requires ((std::is_lvalue_reference_v<Containers> == false) or ...)
+          void zip_view(Containers &&...others) const & = delete;
+
+        template<typename ...Containers>
+          void zip_view(Containers &&...others) && = delete;
 
         template<typename Predicate>
           std::size_t count(Predicate predicate) const
           {
+            JMIXIN_TRACE("count");
+
             return std::count_if(std::begin(*this), std::end(*this), predicate);
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Predicate, typename ExecutionPolicy>
           std::size_t count(ExecutionPolicy &&policy, Predicate predicate) const
           {
-            return std::count_if(policy, std::begin(*this), std::end(*this), predicate);
+            JMIXIN_TRACE("count(par)");
+
+            return parallel::count_if(policy, std::begin(*this), std::end(*this), predicate);
+          }
+
+        // count_by, group_by and reduce_by_key return one (key, value) pair
+        // per distinct key(item), in the order the keys first appear.
+        template<typename KeyFunction>
+          auto count_by(KeyFunction key) const
+          {
+            JMIXIN_TRACE("count_by");
+
+            auto result = jmixin::aggregate(std::begin(*this), std::end(*this), key, std::size_t{0}, [](std::size_t &value, const auto &) {
+                value++;
+            });
+
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<decltype(result)>{std::move(result)};
+          }
+
+        template<typename KeyFunction, typename ExecutionPolicy>
+          auto count_by(ExecutionPolicy &&policy, KeyFunction key) const
+          {
+            JMIXIN_TRACE("count_by(par)");
+
+            auto result = parallel::aggregate(policy, std::begin(*this), std::end(*this), key, std::size_t{0}, [](std::size_t &value, const auto &) {
+                value++;
+            }, [](std::size_t &value, std::size_t partial) {
+                value += partial;
+            });
+
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<decltype(result)>{std::move(result)};
+          }
+
+        template<typename KeyFunction>
+          auto group_by(KeyFunction key) const
+          {
+            JMIXIN_TRACE("group_by");
+
+            auto result = jmixin::aggregate(std::begin(*this), std::end(*this), key, make_like<Container>(*this), [](Container &value, const auto &item) {
+                value.insert(std::end(value), item);
+            });
+
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<decltype(result)>{std::move(result)};
+          }
+
+        template<typename KeyFunction, typename ExecutionPolicy>
+          auto group_by(ExecutionPolicy &&policy, KeyFunction key) const
+          {
+            JMIXIN_TRACE("group_by(par)");
+
+            auto result = parallel::aggregate(policy, std::begin(*this), std::end(*this), key, make_like<Container>(*this), [](Container &value, const auto &item) {
+                value.insert(std::end(value), item);
+            }, [](Container &value, Container &&partial) {
+                for (auto &item : partial) {
+                  value.insert(std::end(value), std::move(item));
+                }
+            });
+
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<decltype(result)>{std::move(result)};
+          }
+
+        template<typename KeyFunction, typename Operation, typename Initial = typename Container::value_type>
+          auto reduce_by_key(KeyFunction key, Operation operation, Initial initial = Initial()) const
+          {
+            JMIXIN_TRACE("reduce_by_key");
+
+            auto result = jmixin::aggregate(std::begin(*this), std::end(*this), key, initial, [&operation](Initial &value, const auto &item) {
+                value = operation(value, item);
+            });
+
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<decltype(result)>{std::move(result)};
+          }
+
+        // As in std::reduce, operation must be associative and initial must be
+        // its identity, since every chunk starts its groups from initial.
+        template<typename KeyFunction, typename Operation, typename ExecutionPolicy, typename Initial = typename Container::value_type>
+          requires parallel::is_policy_v<ExecutionPolicy>
+          auto reduce_by_key(ExecutionPolicy &&policy, KeyFunction key, Operation operation, Initial initial = Initial()) const
+          {
+            JMIXIN_TRACE("reduce_by_key(par)");
+
+            auto result = parallel::aggregate(policy, std::begin(*this), std::end(*this), key, initial, [&operation](Initial &value, const auto &item) {
+                value = operation(value, item);
+            }, [&operation](Initial &value, Initial &&partial) {
+                value = operation(value, std::move(partial));
+            });
+
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<decltype(result)>{std::move(result)};
           }
-#endif
 
         template<typename Predicate>
-          Iterator<Container> & filter(Predicate predicate)
+          Iterator<Container> & filter(Predicate predicate) &
           {
+            JMIXIN_TRACE("filter");
+
             this->erase(std::remove_if(std::begin(*this), std::end(*this), [&predicate](const auto &item) {return !predicate(item);}), std::end(*this));
 
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        template<typename Predicate>
+          Iterator<Container> && filter(Predicate predicate) &&
+          {
+            return std::move(filter(std::move(predicate)));
+          }
+
         template<typename Predicate, typename ExecutionPolicy>
-          Iterator<Container> & filter(ExecutionPolicy &&policy, Predicate predicate)
+          Iterator<Container> & filter(ExecutionPolicy &&policy, Predicate predicate) &
           {
-            this->erase(std::remove_if(policy, std::begin(*this), std::end(*this), [&predicate](const auto &item) {return !predicate(item);}), std::end(*this));
+            JMIXIN_TRACE("filter(par)");
+
+            parallel::compact(policy, static_cast<Container &>(*this), [&predicate](const auto &item, std::size_t) {
+                return predicate(item);
+            });
 
             return *this;
           }
-#endif
 
-        Iterator<Container> & step(std::size_t n)
+        template<typename Predicate, typename ExecutionPolicy>
+          Iterator<Container> && filter(ExecutionPolicy &&policy, Predicate predicate) &&
+          {
+            return std::move(filter(std::forward<ExecutionPolicy>(policy), std::move(predicate)));
+          }
+
+        Iterator<Container> & step(std::size_t n) &
         {
+          JMIXIN_TRACE("step");
+
           return this->filter([i=0, n](auto const &) mutable {
               if ((i++ % n) == 0) {
                 return true;
@@ -110,28 +317,39 @@ namespace jmixin {
           });
         }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
-        template<typename Predicate, typename ExecutionPolicy>
-        Iterator<Container> & step(ExecutionPolicy policy, std::size_t n)
+        Iterator<Container> && step(std::size_t n) &&
         {
-          return this->filter(policy, [i=0, n](auto const &) mutable {
-              if ((i++ % n) == 0) {
-                return true;
-              }
-
-              return false;
-          });
+          return std::move(step(n));
         }
-#endif
+
+        template<typename ExecutionPolicy>
+          Iterator<Container> & step(ExecutionPolicy &&policy, std::size_t n) &
+          {
+            JMIXIN_TRACE("step(par)");
+
+            parallel::compact(policy, static_cast<Container &>(*this), [n](const auto &, std::size_t index) {
+                return (index % n) == 0;
+            });
+
+            return *this;
+          }
+
+        template<typename ExecutionPolicy>
+          Iterator<Container> && step(ExecutionPolicy &&policy, std::size_t n) &&
+          {
+            return std::move(step(std::forward<ExecutionPolicy>(policy), n));
+          }
 
         template<typename Container2, typename Predicate>
-          Iterator<Container> & combine(Container2 other, Predicate predicate)
+          Iterator<Container> & combine(const Container2 &other, Predicate predicate) &
           {
+            JMIXIN_TRACE("combine");
+
             if (std::size(*this) != std::size(other)) {
               throw std::runtime_error("Both containers must have the same size");
             }
 
-            Iterator<Container> result;
+            Iterator<Container> result = make_like<Container>(*this);
 
             auto it1 = std::begin(*this);
             auto it2 = std::begin(other);
@@ -145,9 +363,17 @@ namespace jmixin {
             return *this;
           }
 
+        template<typename Container2, typename Predicate>
+          Iterator<Container> && combine(const Container2 &other, Predicate predicate) &&
+          {
+            return std::move(combine(other, std::move(predicate)));
+          }
+
         template<typename Container2>
-          Iterator<std::vector<std::pair<typename Container::value_type, typename Container2::value_type>>> pairs(Container2 other) const
+          Iterator<std::vector<std::pair<typename Container::value_type, typename Container2::value_type>>> pairs(const Container2 &other) const
           {
+            JMIXIN_TRACE("pairs");
+
             if (std::size(*this) != std::size(other)) {
               throw std::runtime_error("Both containers must have the same size");
             }
@@ -161,54 +387,64 @@ namespace jmixin {
               result.insert(std::end(result), std::make_pair(*it1, *it2));
             }
 
+            JMIXIN_TRACE_OUTPUT(result);
+
             return result;
           }
 
         template<typename Container2>
-          bool eq(Container2 other) const
+          bool eq(const Container2 &other) const
           {
+            JMIXIN_TRACE("eq");
+
             return std::equal(std::begin(*this), std::end(*this), std::begin(other));
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Container2, typename ExecutionPolicy>
-          bool eq(ExecutionPolicy &&policy, Container2 other) const
+          bool eq(ExecutionPolicy &&policy, const Container2 &other) const
           {
-            return std::equal(policy, std::begin(*this), std::end(*this), std::begin(other));
+            JMIXIN_TRACE("eq(par)");
+
+            return parallel::equal(policy, std::begin(*this), std::end(*this), std::begin(other));
           }
-#endif
 
         template<typename Container2>
-          bool ne(Container2 other) const
+          bool ne(const Container2 &other) const
           {
+            JMIXIN_TRACE("ne");
+
             return !eq(other);
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Container2, typename ExecutionPolicy>
-          bool ne(ExecutionPolicy &&policy, Container2 other) const
+          bool ne(ExecutionPolicy &&policy, const Container2 &other) const
           {
+            JMIXIN_TRACE("ne(par)");
+
             return !eq(policy, other);
           }
-#endif
 
         template<typename Container2>
-          bool lt(Container2 other) const
+          bool lt(const Container2 &other) const
           {
+            JMIXIN_TRACE("lt");
+
             return lexicographical_compare(std::begin(*this), std::end(*this), std::begin(other), std::end(other));
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Container2, typename ExecutionPolicy>
-          bool lt(ExecutionPolicy &&policy, Container2 other) const
+          bool lt(ExecutionPolicy &&policy, const Container2 &other) const
           {
-            return lexicographical_compare(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other));
+            JMIXIN_TRACE("lt(par)");
+
+            return parallel::lexicographical_compare(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other));
           }
-#endif
 
         template<typename Container2>
-          bool le(Container2 other) const
+          bool le(const Container2 &other) const
           {
+            JMIXIN_TRACE("le");
+
             if (eq(other) == true or lt(other) == true) {
               return true;
             }
@@ -216,49 +452,55 @@ namespace jmixin {
             return false;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Container2, typename ExecutionPolicy>
-          bool le(ExecutionPolicy &&policy, Container2 other) const
+          bool le(ExecutionPolicy &&policy, const Container2 &other) const
           {
+            JMIXIN_TRACE("le(par)");
+
             if (eq(policy, other) == true or lt(policy, other) == true) {
               return true;
             }
 
             return false;
           }
-#endif
 
         template<typename Container2>
-          bool gt(Container2 other) const
+          bool gt(const Container2 &other) const
           {
+            JMIXIN_TRACE("gt");
+
             return !le(other);
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Container2, typename ExecutionPolicy>
-          bool gt(ExecutionPolicy &&policy, Container2 other) const
+          bool gt(ExecutionPolicy &&policy, const Container2 &other) const
           {
+            JMIXIN_TRACE("gt(par)");
+
             return !le(policy, other);
           }
-#endif
 
         template<typename Container2>
-          bool ge(Container2 other) const
+          bool ge(const Container2 &other) const
           {
+            JMIXIN_TRACE("ge");
+
             return !lt(other);
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Container2, typename ExecutionPolicy>
-          bool ge(ExecutionPolicy &&policy, Container2 other) const
+          bool ge(ExecutionPolicy &&policy, const Container2 &other) const
           {
+            JMIXIN_TRACE("ge(par)");
+
             return !lt(policy, other);
           }
-#endif
 
         template<typename Container2>
-          bool cmp(Container2 other) const
+          bool cmp(const Container2 &other) const
           {
+            JMIXIN_TRACE("cmp");
+
             if (equal(other) == true) {
               return 0;
             }
@@ -270,10 +512,11 @@ namespace jmixin {
             return +1;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Container2, typename ExecutionPolicy>
-          bool cmp(ExecutionPolicy &&policy, Container2 other) const
+          bool cmp(ExecutionPolicy &&policy, const Container2 &other) const
           {
+            JMIXIN_TRACE("cmp(par)");
+
             if (equal(policy, other) == true) {
               return 0;
             }
@@ -284,11 +527,12 @@ namespace jmixin {
 
             return +1;
           }
-#endif
 
         template<typename Callback>
-          Iterator<Container> & for_each(Callback callback, std::function<void()> begin = nullptr, std::function<void()> end = nullptr)
+          Iterator<Container> & for_each(Callback callback, std::function<void()> begin = nullptr, std::function<void()> end = nullptr) &
           {
+            JMIXIN_TRACE("for_each");
+
             if (begin) {
               begin();
             }
@@ -302,15 +546,22 @@ namespace jmixin {
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        template<typename Callback>
+          Iterator<Container> && for_each(Callback callback, std::function<void()> begin = nullptr, std::function<void()> end = nullptr) &&
+          {
+            return std::move(for_each(std::move(callback), std::move(begin), std::move(end)));
+          }
+
         template<typename Callback, typename ExecutionPolicy>
-          Iterator<Container> & for_each(ExecutionPolicy &&policy, Callback callback, std::function<void()> begin, std::function<void()> end)
+          Iterator<Container> & for_each(ExecutionPolicy &&policy, Callback callback, std::function<void()> begin, std::function<void()> end) &
           {
+            JMIXIN_TRACE("for_each(par)");
+
             if (begin) {
               begin();
             }
 
-            std::for_each(policy, std::begin(*this), std::end(*this), callback);
+            parallel::for_each(policy, std::begin(*this), std::end(*this), callback);
 
             if (end) {
               end();
@@ -318,72 +569,113 @@ namespace jmixin {
 
             return *this;
           }
-#endif
+
+        template<typename Callback, typename ExecutionPolicy>
+          Iterator<Container> && for_each(ExecutionPolicy &&policy, Callback callback, std::function<void()> begin, std::function<void()> end) &&
+          {
+            return std::move(for_each(std::forward<ExecutionPolicy>(policy), std::move(callback), std::move(begin), std::move(end)));
+          }
 
         template<typename ResultContainer = Container, typename Predicate>
           Iterator<ResultContainer> map(Predicate predicate) const
           {
-            ResultContainer result;
+            JMIXIN_TRACE("map");
+
+            ResultContainer result = make_like<ResultContainer>(*this);
 
             std::transform(std::begin(*this), std::end(*this), std::inserter(result, std::end(result)), predicate);
 
-            return Iterator<ResultContainer>(result);
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<ResultContainer>(std::move(result));
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename ResultContainer = Container, typename Predicate, typename ExecutionPolicy>
           Iterator<ResultContainer> map(ExecutionPolicy &&policy, Predicate predicate) const
           {
-            ResultContainer result;
+            JMIXIN_TRACE("map(par)");
 
-            std::transform(policy, std::begin(*this), std::end(*this), std::inserter(result, std::end(result)), predicate);
+            ResultContainer result = make_like<ResultContainer>(*this);
 
-            return Iterator<ResultContainer>(result);
+            parallel::transform(policy, std::begin(*this), std::end(*this), result, predicate);
+
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<ResultContainer>(std::move(result));
           }
-#endif
 
         template<typename Result = Container>
           Iterator<Result> build(std::function<Result(Container &)> f)
           {
+            JMIXIN_TRACE("build");
+
             return f(*this);
           }
 
-        Iterator<Container> & fill(typename Container::value_type value)
+        Iterator<Container> & fill(typename Container::value_type value) &
         {
+          JMIXIN_TRACE("fill");
+
           std::fill(std::begin(*this), std::end(*this), value);
 
           return *this;
         }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        Iterator<Container> && fill(typename Container::value_type value) &&
+        {
+          return std::move(fill(value));
+        }
+
         template<typename ExecutionPolicy>
-          Iterator<Container> & fill(ExecutionPolicy &&policy, typename Container::value_type value)
+          Iterator<Container> & fill(ExecutionPolicy &&policy, typename Container::value_type value) &
           {
-            std::fill(policy, std::begin(*this), std::end(*this), value);
+            JMIXIN_TRACE("fill(par)");
+
+            parallel::fill(policy, std::begin(*this), std::end(*this), value);
 
             return *this;
           }
-#endif
 
-        Iterator<Container> & fill_n(std::size_t n, typename Container::value_type value)
+        template<typename ExecutionPolicy>
+          Iterator<Container> && fill(ExecutionPolicy &&policy, typename Container::value_type value) &&
+          {
+            return std::move(fill(std::forward<ExecutionPolicy>(policy), value));
+          }
+
+        Iterator<Container> & fill_n(std::size_t n, typename Container::value_type value) &
         {
+          JMIXIN_TRACE("fill_n");
+
           std::fill_n(std::begin(*this), n, value);
 
           return *this;
         }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        Iterator<Container> && fill_n(std::size_t n, typename Container::value_type value) &&
+        {
+          return std::move(fill_n(n, value));
+        }
+
         template<typename ExecutionPolicy>
-          Iterator<Container> & fill_n(ExecutionPolicy &&policy, std::size_t n, typename Container::value_type value)
+          Iterator<Container> & fill_n(ExecutionPolicy &&policy, std::size_t n, typename Container::value_type value) &
           {
-            std::fill_n(policy, std::begin(*this), n, value);
+            JMIXIN_TRACE("fill_n(par)");
+
+            parallel::fill_n(policy, std::begin(*this), n, value);
 
             return *this;
           }
-#endif
 
-        Iterator<Container> & skip(std::size_t n = 1)
+        template<typename ExecutionPolicy>
+          Iterator<Container> && fill_n(ExecutionPolicy &&policy, std::size_t n, typename Container::value_type value) &&
+          {
+            return std::move(fill_n(std::forward<ExecutionPolicy>(policy), n, value));
+          }
+
+        Iterator<Container> & skip(std::size_t n = 1) &
         {
+          JMIXIN_TRACE("skip");
+
           std::size_t i = 0;
 
           return this->filter([&i, n](auto const &) mutable {
@@ -395,24 +687,33 @@ namespace jmixin {
           });
         }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        Iterator<Container> && skip(std::size_t n = 1) &&
+        {
+          return std::move(skip(n));
+        }
+
         template<typename ExecutionPolicy>
-          Iterator<Container> & skip(ExecutionPolicy &&policy, std::size_t n)
+          Iterator<Container> & skip(ExecutionPolicy &&policy, std::size_t n) &
           {
-            std::size_t i = 0;
+            JMIXIN_TRACE("skip(par)");
 
-            return this->filter(policy, [&i, n](auto const &) mutable {
-                if (++i > n) {
-                  return true;
-                }
-
-                return false;
+            parallel::compact(policy, static_cast<Container &>(*this), [n](const auto &, std::size_t index) {
+                return index >= n;
             });
+
+            return *this;
+          }
+
+        template<typename ExecutionPolicy>
+          Iterator<Container> && skip(ExecutionPolicy &&policy, std::size_t n) &&
+          {
+            return std::move(skip(std::forward<ExecutionPolicy>(policy), n));
           }
-#endif
 
-        Iterator<Container> & take(std::size_t n)
+        Iterator<Container> & take(std::size_t n) &
         {
+          JMIXIN_TRACE("take");
+
           std::size_t i = 0;
 
           return this->filter([&i, n](auto const &) mutable {
@@ -424,24 +725,33 @@ namespace jmixin {
           });
         }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        Iterator<Container> && take(std::size_t n) &&
+        {
+          return std::move(take(n));
+        }
+
         template<typename ExecutionPolicy>
-          Iterator<Container> & take(ExecutionPolicy &&policy, std::size_t n)
+          Iterator<Container> & take(ExecutionPolicy &&policy, std::size_t n) &
           {
-            std::size_t i = 0;
-
-            return this->filter(policy, [&i, n](auto const &) mutable {
-                if (i++ < n) {
-                  return true;
-                }
+            JMIXIN_TRACE("take(par)");
 
-                return false;
+            parallel::compact(policy, static_cast<Container &>(*this), [n](const auto &, std::size_t index) {
+                return index < n;
             });
+
+            return *this;
+          }
+
+        template<typename ExecutionPolicy>
+          Iterator<Container> && take(ExecutionPolicy &&policy, std::size_t n) &&
+          {
+            return std::move(take(std::forward<ExecutionPolicy>(policy), n));
           }
-#endif
 
-        Iterator<Container> & chop(std::size_t n = 1)
+        Iterator<Container> & chop(std::size_t n = 1) &
         {
+          JMIXIN_TRACE("chop");
+
           if (n > std::size(*this)) {
             n = std::size(*this);
           }
@@ -451,85 +761,190 @@ namespace jmixin {
           return *this;
         }
 
-        Iterator<Container> & reverse()
+        Iterator<Container> && chop(std::size_t n = 1) &&
         {
-          std::reverse(std::begin(*this), std::end(*this));
-
-          return *this;
+          return std::move(chop(n));
         }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
-        template<typename ExecutionPolicy>
-          Iterator<Container> & reverse(ExecutionPolicy &&policy)
-          {
-            std::reverse(policy, std::begin(*this), std::end(*this));
-
-            return *this;
-          }
-#endif
-
-        Iterator<Container> & shuffle()
+        Iterator<Container> & reverse() &
         {
-          std::random_device rd;
-          std::mt19937 g(rd());
+          JMIXIN_TRACE("reverse");
 
-          std::shuffle(std::begin(*this), std::end(*this), g);
+          std::reverse(std::begin(*this), std::end(*this));
 
           return *this;
         }
 
-        Iterator<Container> sample(std::size_t n) const
+        Iterator<Container> && reverse() &&
         {
-          Container result;
+          return std::move(reverse());
+        }
 
-          if (n > std::size(*this)) {
-            n = std::size(*this);
-          }
+        template<typename ExecutionPolicy>
+          Iterator<Container> & reverse(ExecutionPolicy &&policy) &
+          {
+            JMIXIN_TRACE("reverse(par)");
 
-          std::random_device rd;
-          std::mt19937 g(rd());
+            parallel::reverse(policy, std::begin(*this), std::end(*this));
 
-          std::sample(std::begin(*this), std::end(*this), std::inserter(result, std::end(result)), n, g);
+            return *this;
+          }
 
-          return Iterator<Container>(result);
-        }
+        template<typename ExecutionPolicy>
+          Iterator<Container> && reverse(ExecutionPolicy &&policy) &&
+          {
+            return std::move(reverse(std::forward<ExecutionPolicy>(policy)));
+          }
 
-        Iterator<Container> & left_rotate(std::size_t n)
+        Iterator<Container> & shuffle() &
         {
-          std::rotate(std::begin(*this), std::next(std::begin(*this), n), std::end(*this));
+          return shuffle(default_engine());
+        }
 
-          return *this;
+        Iterator<Container> && shuffle() &&
+        {
+          return std::move(shuffle());
         }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
-        template<typename ExecutionPolicy>
-          Iterator<Container> & left_rotate(ExecutionPolicy &&policy, std::size_t n)
+        template<typename URBG>
+          requires std::uniform_random_bit_generator<std::remove_reference_t<URBG>>
+          Iterator<Container> & shuffle(URBG &&g) &
           {
-            std::rotate(policy, std::begin(*this), std::next(std::begin(*this), n), std::end(*this));
+            JMIXIN_TRACE("shuffle");
+
+            random::shuffle(std::begin(*this), std::end(*this), g);
 
             return *this;
           }
-#endif
 
-        Iterator<Container> & right_rotate(std::size_t n)
-        {
-          std::rotate(this->rbegin(), std::next(this->rbegin(), n), this->rend());
+        template<typename URBG>
+          requires std::uniform_random_bit_generator<std::remove_reference_t<URBG>>
+          Iterator<Container> && shuffle(URBG &&g) &&
+          {
+            return std::move(shuffle(g));
+          }
 
-          return *this;
-        }
+        template<typename ExecutionPolicy>
+          requires parallel::is_policy_v<ExecutionPolicy>
+          Iterator<Container> & shuffle(ExecutionPolicy &&policy) &
+          {
+            return shuffle(std::forward<ExecutionPolicy>(policy), default_engine());
+          }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename ExecutionPolicy>
-          Iterator<Container> & right_rotate(ExecutionPolicy &&policy, std::size_t n)
+          requires parallel::is_policy_v<ExecutionPolicy>
+          Iterator<Container> && shuffle(ExecutionPolicy &&policy) &&
+          {
+            return std::move(shuffle(std::forward<ExecutionPolicy>(policy)));
+          }
+
+        // The result for a given seed depends on the number of threads.
+        template<typename ExecutionPolicy, typename URBG>
+          requires parallel::is_policy_v<ExecutionPolicy>
+          Iterator<Container> & shuffle(ExecutionPolicy &&policy, URBG &&g) &
           {
-            std::rotate(policy, this->rbegin(), std::next(this->rbegin(), n), this->rend());
+            JMIXIN_TRACE("shuffle(par)");
+
+            parallel::shuffle(policy, std::begin(*this), std::end(*this), g);
 
             return *this;
           }
-#endif
+
+        template<typename ExecutionPolicy, typename URBG>
+          requires parallel::is_policy_v<ExecutionPolicy>
+          Iterator<Container> && shuffle(ExecutionPolicy &&policy, URBG &&g) &&
+          {
+            return std::move(shuffle(std::forward<ExecutionPolicy>(policy), g));
+          }
+
+        Iterator<Container> sample(std::size_t n) const
+        {
+          return sample(n, default_engine());
+        }
+
+        // Keeps the order of the items.
+        template<typename URBG>
+          Iterator<Container> sample(std::size_t n, URBG &&g) const
+          {
+            JMIXIN_TRACE("sample");
+
+            Container result = make_like<Container>(*this);
+
+            if (n > std::size(*this)) {
+              n = std::size(*this);
+            }
+
+            std::sample(std::begin(*this), std::end(*this), std::inserter(result, std::end(result)), n, g);
+
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<Container>(std::move(result));
+          }
+
+        Iterator<Container> & left_rotate(std::size_t n) &
+        {
+          JMIXIN_TRACE("left_rotate");
+
+          std::rotate(std::begin(*this), std::next(std::begin(*this), n), std::end(*this));
+
+          return *this;
+        }
+
+        Iterator<Container> && left_rotate(std::size_t n) &&
+        {
+          return std::move(left_rotate(n));
+        }
+
+        template<typename ExecutionPolicy>
+          Iterator<Container> & left_rotate(ExecutionPolicy &&policy, std::size_t n) &
+          {
+            JMIXIN_TRACE("left_rotate(par)");
+
+            parallel::rotate(policy, std::begin(*this), std::next(std::begin(*this), n), std::end(*this));
+
+            return *this;
+          }
+
+        template<typename ExecutionPolicy>
+          Iterator<Container> && left_rotate(ExecutionPolicy &&policy, std::size_t n) &&
+          {
+            return std::move(left_rotate(std::forward<ExecutionPolicy>(policy), n));
+          }
+
+        Iterator<Container> & right_rotate(std::size_t n) &
+        {
+          JMIXIN_TRACE("right_rotate");
+
+          std::rotate(this->rbegin(), std::next(this->rbegin(), n), this->rend());
+
+          return *this;
+        }
+
+        Iterator<Container> && right_rotate(std::size_t n) &&
+        {
+          return std::move(right_rotate(n));
+        }
+
+        template<typename ExecutionPolicy>
+          Iterator<Container> & right_rotate(ExecutionPolicy &&policy, std::size_t n) &
+          {
+            JMIXIN_TRACE("right_rotate(par)");
+
+            parallel::rotate(policy, this->rbegin(), std::next(this->rbegin(), n), this->rend());
+
+            return *this;
+          }
+
+        template<typename ExecutionPolicy>
+          Iterator<Container> && right_rotate(ExecutionPolicy &&policy, std::size_t n) &&
+          {
+            return std::move(right_rotate(std::forward<ExecutionPolicy>(policy), n));
+          }
 
         std::vector<std::pair<std::size_t, typename Container::value_type>> enumerate() const
         {
+          JMIXIN_TRACE("enumerate");
+
           std::vector<std::pair<std::size_t, typename Container::value_type>> result;
           std::size_t i {0};
 
@@ -537,19 +952,31 @@ namespace jmixin {
             result.push_back(std::make_pair(i++, item));
           }
 
-          return Iterator<std::vector<std::pair<std::size_t, typename Container::value_type>>>(result);
+          JMIXIN_TRACE_OUTPUT(result);
+
+          return Iterator<std::vector<std::pair<std::size_t, typename Container::value_type>>>(std::move(result));
         }
 
         template<typename Container2>
-          Iterator<Container> & swap(Container2 other)
+          Iterator<Container> & swap(Container2 other) &
           {
+            JMIXIN_TRACE("swap");
+
             std::swap(*this, other);
 
             return *this;
           }
 
+        template<typename Container2>
+          Iterator<Container> && swap(Container2 other) &&
+          {
+            return std::move(swap(std::move(other)));
+          }
+
         std::optional<typename Container::value_type> first() const
         {
+          JMIXIN_TRACE("first");
+
           if (std::size(*this) == 0) {
             return {};
           }
@@ -559,6 +986,8 @@ namespace jmixin {
 
         std::optional<typename Container::value_type> last() const
         {
+          JMIXIN_TRACE("last");
+
           if (std::size(*this) == 0) {
             return {};
           }
@@ -568,12 +997,16 @@ namespace jmixin {
 
         std::optional<typename Container::value_type> nth(std::size_t n) const
         {
+          JMIXIN_TRACE("nth");
+
           return {*std::next(std::begin(*this), n)};
         }
 
         template<typename Predicate>
           std::optional<typename Container::value_type> find_first(Predicate predicate) const
           {
+            JMIXIN_TRACE("find_first");
+
             auto i = std::find_if(std::begin(*this), std::end(*this), predicate);
 
             if (i != std::end(*this)) {
@@ -586,6 +1019,8 @@ namespace jmixin {
         template<typename Predicate>
           std::optional<typename Container::value_type> find_last(Predicate predicate) const
           {
+            JMIXIN_TRACE("find_last");
+
             auto last = std::end(*this);
 
             for (auto i=std::begin(*this); i!=std::end(*this); i++) {
@@ -604,6 +1039,16 @@ namespace jmixin {
         template<typename Compare = std::less<>>
           std::optional<typename Container::value_type> min(Compare compare = Compare()) const
           {
+            JMIXIN_TRACE("min");
+
+            if constexpr (simd::is_simd_range_v<Container> and simd::is_less_v<Compare, typename Container::value_type>) {
+              if (std::empty(*this) == true) {
+                return {};
+              }
+
+              return {simd::min(std::data(*this), std::size(*this))};
+            }
+
             auto i = std::min_element(std::begin(*this), std::end(*this), compare);
 
             if (i == std::end(*this)) {
@@ -616,6 +1061,16 @@ namespace jmixin {
         template<typename Compare = std::less<>>
           std::optional<typename Container::value_type> max(Compare compare = Compare()) const
           {
+            JMIXIN_TRACE("max");
+
+            if constexpr (simd::is_simd_range_v<Container> and simd::is_less_v<Compare, typename Container::value_type>) {
+              if (std::empty(*this) == true) {
+                return {};
+              }
+
+              return {simd::max(std::data(*this), std::size(*this))};
+            }
+
             auto i = std::max_element(std::begin(*this), std::end(*this), compare);
 
             if (i == std::end(*this)) {
@@ -625,9 +1080,45 @@ namespace jmixin {
             return {*i};
           }
 
+        // Finds the first minimum and the first maximum, with their positions,
+        // in a single pass.
+        template<typename Compare = std::less<>>
+          std::optional<MinMax<typename Container::value_type>> minmax(Compare compare = Compare()) const
+          {
+            JMIXIN_TRACE("minmax");
+
+            if (std::empty(*this) == true) {
+              return {};
+            }
+
+            if constexpr (simd::is_simd_range_v<Container> and simd::is_less_v<Compare, typename Container::value_type>) {
+              return {simd::minmax(std::data(*this), std::size(*this))};
+            }
+
+            auto i = std::begin(*this);
+
+            MinMax<typename Container::value_type> result {*i, *i, 0, 0};
+
+            for (std::size_t position=1; ++i!=std::end(*this); position++) {
+              if (compare(*i, result.min) == true) {
+                result.min = *i;
+                result.min_position = position;
+              }
+
+              if (compare(result.max, *i) == true) {
+                result.max = *i;
+                result.max_position = position;
+              }
+            }
+
+            return {result};
+          }
+
         template<typename Predicate>
           std::optional<std::size_t> position(Predicate predicate) const
           {
+            JMIXIN_TRACE("position");
+
             auto i = std::find_if(std::begin(*this), std::end(*this), predicate);
 
             if (i != std::end(*this)) {
@@ -637,11 +1128,12 @@ namespace jmixin {
             return {};
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Predicate, typename ExecutionPolicy>
           std::optional<std::size_t> position(ExecutionPolicy &&policy, Predicate predicate) const
           {
-            auto i = std::find_if(policy, std::begin(*this), std::end(*this), predicate);
+            JMIXIN_TRACE("position(par)");
+
+            auto i = parallel::find_if(policy, std::begin(*this), std::end(*this), predicate);
 
             if (i != std::end(*this)) {
               return {std::distance(std::begin(*this), i)};
@@ -649,70 +1141,237 @@ namespace jmixin {
 
             return {};
           }
-#endif
 
         template<typename Predicate>
           bool all(Predicate predicate) const
           {
+            JMIXIN_TRACE("all");
+
             return std::all_of(std::begin(*this), std::end(*this), predicate);
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Predicate, typename ExecutionPolicy>
           bool all(ExecutionPolicy &&policy, Predicate predicate) const
           {
-            return std::all_of(policy, std::begin(*this), std::end(*this), predicate);
+            JMIXIN_TRACE("all(par)");
+
+            return parallel::all_of(policy, std::begin(*this), std::end(*this), predicate);
           }
-#endif
 
         template<typename Predicate>
           bool any(Predicate predicate) const
           {
+            JMIXIN_TRACE("any");
+
             return std::any_of(std::begin(*this), std::end(*this), predicate);
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Predicate, typename ExecutionPolicy>
           bool any(ExecutionPolicy &&policy, Predicate predicate) const
           {
-            return std::any_of(policy, std::begin(*this), std::end(*this), predicate);
+            JMIXIN_TRACE("any(par)");
+
+            return parallel::any_of(policy, std::begin(*this), std::end(*this), predicate);
           }
-#endif
 
         template<typename Predicate>
           bool none(Predicate predicate) const
           {
+            JMIXIN_TRACE("none");
+
             return std::none_of(std::begin(*this), std::end(*this), predicate);
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Predicate, typename ExecutionPolicy>
           bool none(ExecutionPolicy &&policy, Predicate predicate) const
           {
-            return std::none_of(policy, std::begin(*this), std::end(*this), predicate);
+            JMIXIN_TRACE("none(par)");
+
+            return parallel::none_of(policy, std::begin(*this), std::end(*this), predicate);
           }
-#endif
 
         template<typename Compare = std::less<>>
-          Iterator<Container> & sort(Compare compare = Compare())
+          Iterator<Container> & sort(Compare compare = Compare()) &
+          {
+            JMIXIN_TRACE("sort");
+
+            sorting::sort(std::begin(*this), std::end(*this), compare);
+
+            return *this;
+          }
+
+        template<typename Compare = std::less<>>
+          SortedIterator<Container, Compare> sort(Compare compare = Compare()) &&
+          {
+            sort(compare);
+
+            return SortedIterator<Container, Compare>(std::move(*this), std::move(compare));
+          }
+
+        template<typename Compare = std::less<>, typename ExecutionPolicy>
+          Iterator<Container> & sort(ExecutionPolicy &&policy, Compare compare) &
           {
-            std::sort(std::begin(*this), std::end(*this), compare);
+            JMIXIN_TRACE("sort(par)");
+
+            parallel::sort(policy, std::begin(*this), std::end(*this), compare);
 
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Compare = std::less<>, typename ExecutionPolicy>
-          Iterator<Container> & sort(ExecutionPolicy &&policy, Compare compare)
+          SortedIterator<Container, Compare> sort(ExecutionPolicy &&policy, Compare compare) &&
+          {
+            sort(std::forward<ExecutionPolicy>(policy), compare);
+
+            return SortedIterator<Container, Compare>(std::move(*this), std::move(compare));
+          }
+
+        // Stable sort by the order of key(item); numeric keys are radix sorted,
+        // so an extracted key costs no comparisons.
+        template<typename Key>
+          Iterator<Container> & sort_by(Key key) &
           {
-            std::sort(policy, std::begin(*this), std::end(*this), compare);
+            JMIXIN_TRACE("sort_by");
+
+            sorting::sort_by(std::begin(*this), std::end(*this), key);
 
             return *this;
           }
-#endif
 
-        Iterator<Container> & unique()
+        template<typename Key>
+          Iterator<Container> && sort_by(Key key) &&
+          {
+            return std::move(sort_by(std::move(key)));
+          }
+
+        template<typename Key, typename ExecutionPolicy>
+          Iterator<Container> & sort_by(ExecutionPolicy &&policy, Key key) &
+          {
+            JMIXIN_TRACE("sort_by(par)");
+
+            parallel::sort_by(policy, std::begin(*this), std::end(*this), key);
+
+            return *this;
+          }
+
+        template<typename Key, typename ExecutionPolicy>
+          Iterator<Container> && sort_by(ExecutionPolicy &&policy, Key key) &&
+          {
+            return std::move(sort_by(std::forward<ExecutionPolicy>(policy), std::move(key)));
+          }
+
+        // Keeps only the k greatest items (by compare), greatest first, without
+        // sorting the whole container.
+        template<typename Compare = std::less<>>
+          Iterator<Container> & top_k(std::size_t k, Compare compare = Compare()) &
+          {
+            JMIXIN_TRACE("top_k");
+
+            auto greater = [&compare](const auto &a, const auto &b) {
+              return compare(b, a);
+            };
+
+            if constexpr (std::random_access_iterator<typename Container::iterator>) {
+              k = std::min(k, std::size(*this));
+
+              std::nth_element(std::begin(*this), std::begin(*this) + k, std::end(*this), greater);
+              std::sort(std::begin(*this), std::begin(*this) + k, greater);
+
+              this->erase(std::begin(*this) + k, std::end(*this));
+            } else {
+              std::vector<typename Container::value_type> heap;
+
+              parallel::keep_top(std::begin(*this), std::end(*this), k, heap, compare);
+
+              std::sort_heap(std::begin(heap), std::end(heap), greater);
+
+              Container result = make_like<Container>(*this, std::make_move_iterator(std::begin(heap)), std::make_move_iterator(std::end(heap)));
+
+              Container::swap(result);
+            }
+
+            return *this;
+          }
+
+        template<typename Compare = std::less<>>
+          Iterator<Container> && top_k(std::size_t k, Compare compare = Compare()) &&
+          {
+            return std::move(top_k(k, std::move(compare)));
+          }
+
+        template<typename Compare = std::less<>, typename ExecutionPolicy>
+          Iterator<Container> & top_k(ExecutionPolicy &&policy, std::size_t k, Compare compare) &
+          {
+            JMIXIN_TRACE("top_k(par)");
+
+            auto heap = parallel::top_k(policy, std::begin(*this), std::end(*this), k, compare);
+
+            Container result = make_like<Container>(*this, std::make_move_iterator(std::begin(heap)), std::make_move_iterator(std::end(heap)));
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Compare = std::less<>, typename ExecutionPolicy>
+          Iterator<Container> && top_k(ExecutionPolicy &&policy, std::size_t k, Compare compare) &&
+          {
+            return std::move(top_k(std::forward<ExecutionPolicy>(policy), k, std::move(compare)));
+          }
+
+        // Keeps only the k smallest items (by compare), smallest first.
+        template<typename Compare = std::less<>>
+          Iterator<Container> & bottom_k(std::size_t k, Compare compare = Compare()) &
+          {
+            JMIXIN_TRACE("bottom_k");
+
+            return top_k(k, [compare](const auto &a, const auto &b) {
+                return compare(b, a);
+            });
+          }
+
+        template<typename Compare = std::less<>>
+          Iterator<Container> && bottom_k(std::size_t k, Compare compare = Compare()) &&
+          {
+            return std::move(bottom_k(k, std::move(compare)));
+          }
+
+        template<typename Compare = std::less<>, typename ExecutionPolicy>
+          Iterator<Container> & bottom_k(ExecutionPolicy &&policy, std::size_t k, Compare compare) &
+          {
+            JMIXIN_TRACE("bottom_k(par)");
+
+            return top_k(std::forward<ExecutionPolicy>(policy), k, [compare](const auto &a, const auto &b) {
+                return compare(b, a);
+            });
+          }
+
+        template<typename Compare = std::less<>, typename ExecutionPolicy>
+          Iterator<Container> && bottom_k(ExecutionPolicy &&policy, std::size_t k, Compare compare) &&
+          {
+            return std::move(bottom_k(std::forward<ExecutionPolicy>(policy), k, std::move(compare)));
+          }
+
+        // Trusts that the items are already ordered by compare, so the set
+        // operations of the returned SortedIterator skip their validation.
+        template<typename Compare = std::less<>>
+          SortedIterator<Container, Compare> assume_sorted(Compare compare = Compare()) const &
+          {
+            JMIXIN_TRACE("assume_sorted");
+
+            return SortedIterator<Container, Compare>(*this, std::move(compare));
+          }
+
+        template<typename Compare = std::less<>>
+          SortedIterator<Container, Compare> assume_sorted(Compare compare = Compare()) &&
+          {
+            return SortedIterator<Container, Compare>(std::move(*this), std::move(compare));
+          }
+
+        Iterator<Container> & unique() &
         {
+          JMIXIN_TRACE("unique");
+
           if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
             throw std::runtime_error("Container must be sorted");
           }
@@ -722,23 +1381,36 @@ namespace jmixin {
           return *this;
         }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        Iterator<Container> && unique() &&
+        {
+          return std::move(unique());
+        }
+
         template<typename ExecutionPolicy>
-          Iterator<Container> & unique(ExecutionPolicy &&policy)
+          Iterator<Container> & unique(ExecutionPolicy &&policy) &
           {
+            JMIXIN_TRACE("unique(par)");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            this->erase(std::unique(policy, std::begin(*this), std::end(*this)), std::end(*this));
+            this->erase(parallel::unique(policy, std::begin(*this), std::end(*this)), std::end(*this));
 
             return *this;
           }
-#endif
+
+        template<typename ExecutionPolicy>
+          Iterator<Container> && unique(ExecutionPolicy &&policy) &&
+          {
+            return std::move(unique(std::forward<ExecutionPolicy>(policy)));
+          }
 
         template<typename Container2>
-          bool includes(Container2 other) const
+          bool includes(const Container2 &other) const
           {
+            JMIXIN_TRACE("includes");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
@@ -746,26 +1418,28 @@ namespace jmixin {
             return std::includes(std::begin(*this), std::end(*this), std::begin(other), std::end(other));
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Container2,typename ExecutionPolicy>
-          bool includes(ExecutionPolicy &&policy, Container2 other) const
+          bool includes(ExecutionPolicy &&policy, const Container2 &other) const
           {
+            JMIXIN_TRACE("includes(par)");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            return std::includes(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other));
+            return parallel::includes(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other));
           }
-#endif
 
         template<typename Container2>
-          Iterator<Container> & difference(Container2 other)
+          Iterator<Container> & difference(const Container2 &other) &
           {
+            JMIXIN_TRACE("difference");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            Iterator<Container> result;
+            Iterator<Container> result = make_like<Container>(*this);
 
             std::set_difference(std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
 
@@ -774,32 +1448,52 @@ namespace jmixin {
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        template<typename Container2>
+          Iterator<Container> && difference(const Container2 &other) &&
+          {
+            return std::move(difference(other));
+          }
+
         template<typename Container2, typename ExecutionPolicy>
-          Iterator<Container> & difference(ExecutionPolicy &&policy, Container2 other)
+          Iterator<Container> & difference(ExecutionPolicy &&policy, const Container2 &other) &
           {
+            JMIXIN_TRACE("difference(par)");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            Iterator<Container> result;
+            Iterator<Container> result = make_like<Container>(*this);
 
-            std::set_difference(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
+            if constexpr (parallel::is_indexable_v<Container>) {
+              result.resize(std::size(*this));
+
+              result.erase(parallel::set_difference(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::begin(result)), std::end(result));
+            } else {
+              parallel::set_difference(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
+            }
 
             std::swap(*this, result);
 
             return *this;
           }
-#endif
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> && difference(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(difference(std::forward<ExecutionPolicy>(policy), other));
+          }
 
         template<typename Container2>
-          Iterator<Container> & complement(Container2 other)
+          Iterator<Container> & complement(const Container2 &other) &
           {
+            JMIXIN_TRACE("complement");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            Container result;
+            Container result = make_like<Container>(*this);
 
             std::set_difference(std::begin(other), std::end(other), std::begin(*this), std::end(*this), std::inserter(result, std::end(result)));
 
@@ -808,32 +1502,52 @@ namespace jmixin {
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        template<typename Container2>
+          Iterator<Container> && complement(const Container2 &other) &&
+          {
+            return std::move(complement(other));
+          }
+
         template<typename Container2, typename ExecutionPolicy>
-          Iterator<Container> & complement(ExecutionPolicy &&policy, Container2 other)
+          Iterator<Container> & complement(ExecutionPolicy &&policy, const Container2 &other) &
           {
+            JMIXIN_TRACE("complement(par)");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            Container result;
+            Container result = make_like<Container>(*this);
+
+            if constexpr (parallel::is_indexable_v<Container>) {
+              result.resize(std::size(other));
 
-            std::set_difference(policy, std::begin(other), std::end(other), std::begin(*this), std::end(*this), std::inserter(result, std::end(result)));
+              result.erase(parallel::set_difference(policy, std::begin(other), std::end(other), std::begin(*this), std::end(*this), std::begin(result)), std::end(result));
+            } else {
+              parallel::set_difference(policy, std::begin(other), std::end(other), std::begin(*this), std::end(*this), std::inserter(result, std::end(result)));
+            }
 
             std::swap(*this, result);
 
             return *this;
           }
-#endif
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> && complement(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(complement(std::forward<ExecutionPolicy>(policy), other));
+          }
 
         template<typename Container2>
-          Iterator<Container> & intersection(Container2 other)
+          Iterator<Container> & intersection(const Container2 &other) &
           {
+            JMIXIN_TRACE("intersection");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            Iterator<Container> result;
+            Iterator<Container> result = make_like<Container>(*this);
 
             std::set_intersection(std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
 
@@ -842,32 +1556,52 @@ namespace jmixin {
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        template<typename Container2>
+          Iterator<Container> && intersection(const Container2 &other) &&
+          {
+            return std::move(intersection(other));
+          }
+
         template<typename Container2, typename ExecutionPolicy>
-          Iterator<Container> & intersection(ExecutionPolicy &&policy, Container2 other)
+          Iterator<Container> & intersection(ExecutionPolicy &&policy, const Container2 &other) &
           {
+            JMIXIN_TRACE("intersection(par)");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            Iterator<Container> result;
+            Iterator<Container> result = make_like<Container>(*this);
 
-            std::set_intersection(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
+            if constexpr (parallel::is_indexable_v<Container>) {
+              result.resize(std::min<std::size_t>(std::size(*this), std::size(other)));
+
+              result.erase(parallel::set_intersection(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::begin(result)), std::end(result));
+            } else {
+              parallel::set_intersection(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
+            }
 
             std::swap(*this, result);
 
             return *this;
           }
-#endif
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> && intersection(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(intersection(std::forward<ExecutionPolicy>(policy), other));
+          }
 
         template<typename Container2>
-          Iterator<Container> & union_set(Container2 other)
+          Iterator<Container> & union_set(const Container2 &other) &
           {
+            JMIXIN_TRACE("union_set");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            Iterator<Container> result;
+            Iterator<Container> result = make_like<Container>(*this);
 
             std::set_union(std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
 
@@ -876,27 +1610,163 @@ namespace jmixin {
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
-        template<typename Container2, typename ExecutionPolicy>
-          Iterator<Container> & union_set(ExecutionPolicy &&policy, Container2 other)
+        template<typename Container2>
+          Iterator<Container> && union_set(const Container2 &other) &&
           {
+            return std::move(union_set(other));
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> & union_set(ExecutionPolicy &&policy, const Container2 &other) &
+          {
+            JMIXIN_TRACE("union_set(par)");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            Iterator<Container> result;
+            Iterator<Container> result = make_like<Container>(*this);
+
+            if constexpr (parallel::is_indexable_v<Container>) {
+              result.resize(std::size(*this) + std::size(other));
 
-            std::set_union(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
+              result.erase(parallel::set_union(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::begin(result)), std::end(result));
+            } else {
+              parallel::set_union(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
+            }
 
             std::swap(*this, result);
 
             return *this;
           }
-#endif
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> && union_set(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(union_set(std::forward<ExecutionPolicy>(policy), other));
+          }
+
+        // Keeps the items found in other, in their order. Unlike intersection
+        // neither side needs to be sorted: a hash set is built on the smaller
+        // side and probed with the other one.
+        template<typename Container2>
+          Iterator<Container> & hash_intersection(const Container2 &other) &
+          {
+            JMIXIN_TRACE("hash_intersection");
+
+            return hash_filter(other, true, sequential_probe(), [this](auto keep) {
+                filter(keep);
+            });
+          }
+
+        template<typename Container2>
+          Iterator<Container> && hash_intersection(const Container2 &other) &&
+          {
+            return std::move(hash_intersection(other));
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> & hash_intersection(ExecutionPolicy &&policy, const Container2 &other) &
+          {
+            JMIXIN_TRACE("hash_intersection(par)");
+
+            return hash_filter(other, true, parallel_probe(policy), [this, &policy](auto keep) {
+                filter(policy, keep);
+            });
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> && hash_intersection(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(hash_intersection(std::forward<ExecutionPolicy>(policy), other));
+          }
+
+        // Keeps the items not found in other, in their order.
+        template<typename Container2>
+          Iterator<Container> & hash_difference(const Container2 &other) &
+          {
+            JMIXIN_TRACE("hash_difference");
+
+            return hash_filter(other, false, sequential_probe(), [this](auto keep) {
+                filter(keep);
+            });
+          }
+
+        template<typename Container2>
+          Iterator<Container> && hash_difference(const Container2 &other) &&
+          {
+            return std::move(hash_difference(other));
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> & hash_difference(ExecutionPolicy &&policy, const Container2 &other) &
+          {
+            JMIXIN_TRACE("hash_difference(par)");
+
+            return hash_filter(other, false, parallel_probe(policy), [this, &policy](auto keep) {
+                filter(policy, keep);
+            });
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> && hash_difference(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(hash_difference(std::forward<ExecutionPolicy>(policy), other));
+          }
+
+        // Appends the distinct items of other that are not in this, in the
+        // order they first appear in other.
+        template<typename Container2>
+          Iterator<Container> & hash_union(const Container2 &other) &
+          {
+            JMIXIN_TRACE("hash_union");
+
+            return hash_append(other, sequential_probe());
+          }
+
+        template<typename Container2>
+          Iterator<Container> && hash_union(const Container2 &other) &&
+          {
+            return std::move(hash_union(other));
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> & hash_union(ExecutionPolicy &&policy, const Container2 &other) &
+          {
+            JMIXIN_TRACE("hash_union(par)");
+
+            return hash_append(other, parallel_probe(policy));
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> && hash_union(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(hash_union(std::forward<ExecutionPolicy>(policy), other));
+          }
+
+        // Whether every item of other is in this, whatever the order and the
+        // repetitions.
+        template<typename Container2>
+          bool hash_includes(const Container2 &other) const
+          {
+            JMIXIN_TRACE("hash_includes");
+
+            return hash_covers(other, sequential_probe());
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          bool hash_includes(ExecutionPolicy &&policy, const Container2 &other) const
+          {
+            JMIXIN_TRACE("hash_includes(par)");
+
+            return hash_covers(other, parallel_probe(policy));
+          }
 
         template<typename Predicate>
-          Iterator<Container> & generate(Predicate predicate, std::size_t n)
+          Iterator<Container> & generate(Predicate predicate, std::size_t n) &
           {
+            JMIXIN_TRACE("generate");
+
             for (std::size_t i=0; i<n; i++) {
               this->insert(std::end(*this), predicate());
             }
@@ -904,14 +1774,22 @@ namespace jmixin {
             return *this;
           }
 
+        template<typename Predicate>
+          Iterator<Container> && generate(Predicate predicate, std::size_t n) &&
+          {
+            return std::move(generate(std::move(predicate), n));
+          }
+
         template<typename Container2>
-          Iterator<Container> & merge(Container2 other)
+          Iterator<Container> & merge(const Container2 &other) &
           {
+            JMIXIN_TRACE("merge");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            Iterator<Container> result;
+            Iterator<Container> result = make_like<Container>(*this);
 
             std::merge(std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
 
@@ -920,214 +1798,557 @@ namespace jmixin {
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        template<typename Container2>
+          Iterator<Container> && merge(const Container2 &other) &&
+          {
+            return std::move(merge(other));
+          }
+
         template<typename Container2, typename ExecutionPolicy>
-          Iterator<Container> & merge(ExecutionPolicy &&policy, Container2 other)
+          Iterator<Container> & merge(ExecutionPolicy &&policy, const Container2 &other) &
           {
+            JMIXIN_TRACE("merge(par)");
+
             if (std::is_sorted(std::begin(*this), std::end(*this)) == false) {
               throw std::runtime_error("Container must be sorted");
             }
 
-            Iterator<Container> result;
+            Iterator<Container> result = make_like<Container>(*this);
+
+            if constexpr (parallel::is_indexable_v<Container>) {
+              result.resize(std::size(*this) + std::size(other));
 
-            std::merge(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
+              parallel::merge(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::begin(result));
+            } else {
+              std::merge(std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)));
+            }
 
             std::swap(*this, result);
 
             return *this;
           }
-#endif
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> && merge(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(merge(std::forward<ExecutionPolicy>(policy), other));
+          }
 
         template<typename Container2>
-          Iterator<Container> & append(Container2 other)
+          Iterator<Container> & append(const Container2 &other) &
           {
+            JMIXIN_TRACE("append");
+
             std::copy(std::begin(other), std::end(other), std::inserter(*this, std::end(*this)));
 
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        template<typename Container2>
+          Iterator<Container> && append(const Container2 &other) &&
+          {
+            return std::move(append(other));
+          }
+
         template<typename Container2, typename ExecutionPolicy>
-          Iterator<Container> & append(ExecutionPolicy &&policy, Container2 other)
+          Iterator<Container> & append(ExecutionPolicy &&policy, const Container2 &other) &
           {
-            std::copy(policy, std::begin(other), std::end(other), std::inserter(*this, std::end(*this)));
+            JMIXIN_TRACE("append(par)");
+
+            parallel::copy(policy, std::begin(other), std::end(other), static_cast<Container &>(*this));
 
             return *this;
           }
-#endif
+
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> && append(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(append(std::forward<ExecutionPolicy>(policy), other));
+          }
 
         template<typename Container2>
-          Iterator<Container> & prepend(Container2 other)
+          Iterator<Container> & prepend(const Container2 &other) &
           {
+            JMIXIN_TRACE("prepend");
+
             std::copy(std::begin(other), std::end(other), std::inserter(*this, std::begin(*this)));
 
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        template<typename Container2>
+          Iterator<Container> && prepend(const Container2 &other) &&
+          {
+            return std::move(prepend(other));
+          }
+
         template<typename Container2, typename ExecutionPolicy>
-          Iterator<Container> & prepend(ExecutionPolicy &&policy, Container2 other)
+          Iterator<Container> & prepend(ExecutionPolicy &&policy, const Container2 &other) &
           {
-            std::copy(policy, std::begin(other), std::end(other), std::inserter(*this, std::begin(*this)));
+            JMIXIN_TRACE("prepend(par)");
+
+            if constexpr (parallel::is_indexable_v<Container>) {
+              Container result = make_like<Container>(*this);
+
+              parallel::copy(policy, std::begin(other), std::end(other), result);
+              parallel::transform(policy, std::begin(*this), std::end(*this), result, [](auto &item) {
+                  return std::move(item);
+              });
+
+              static_cast<Container &>(*this) = std::move(result);
+            } else {
+              std::copy(std::begin(other), std::end(other), std::inserter(*this, std::begin(*this)));
+            }
 
             return *this;
           }
-#endif
 
-        Iterator<std::vector<Container>> breaks(std::size_t n) const
+        template<typename Container2, typename ExecutionPolicy>
+          Iterator<Container> && prepend(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(prepend(std::forward<ExecutionPolicy>(policy), other));
+          }
+
+        // Splits the items in views of up to n items over the original storage,
+        // spans for contiguous containers and subranges otherwise, so nothing
+        // is copied. The views are invalidated like the container iterators.
+        auto chunks(std::size_t n) &
         {
-          std::vector<Container> result;
+          return Iterator<std::vector<chunk_type<Container>>>{chunk_views(*this, n)};
+        }
 
-          for (const auto &item : *this) {
-            if (result.size() == 0) {
-              result.push_back(Container{});
+        auto chunks(std::size_t n) const &
+        {
+          return Iterator<std::vector<chunk_type<const Container>>>{chunk_views(*this, n)};
+        }
+
+        auto chunks(std::size_t n) && = delete;
+
+        template<typename Callback>
+          Iterator<Container> & for_each_chunk(std::size_t n, Callback callback) &
+          {
+            JMIXIN_TRACE("for_each_chunk");
+
+            for (auto chunk : chunk_views(*this, n)) {
+              callback(chunk);
             }
 
-            Container *container = &result.back();
+            return *this;
+          }
+
+        template<typename Callback>
+          Iterator<Container> && for_each_chunk(std::size_t n, Callback callback) &&
+          {
+            return std::move(for_each_chunk(n, std::move(callback)));
+          }
+
+        // Each chunk is a separate task, so callback may block (a bulk insert,
+        // a network send) without holding back the other chunks.
+        template<typename Callback, typename ExecutionPolicy>
+          Iterator<Container> & for_each_chunk(ExecutionPolicy &&policy, std::size_t n, Callback callback) &
+          {
+            JMIXIN_TRACE("for_each_chunk(par)");
+
+            auto views = chunk_views(*this, n);
 
-            if (container->size() >= n) {
-              result.push_back(Container{});
+            parallel::for_each_chunk(policy, views.size(), views.size(), [&views, &callback](std::size_t chunk, std::size_t, std::size_t) {
+                callback(views[chunk]);
+            });
+
+            return *this;
+          }
+
+        template<typename Callback, typename ExecutionPolicy>
+          Iterator<Container> && for_each_chunk(ExecutionPolicy &&policy, std::size_t n, Callback callback) &&
+          {
+            return std::move(for_each_chunk(std::forward<ExecutionPolicy>(policy), n, std::move(callback)));
+          }
 
-              container = &result.back();
+        // Calls callback with std::span<const value_type> batches of up to n
+        // items, over the storage of contiguous containers and over a copy in
+        // a buffer otherwise, so a sink (a socket, a database writer) pays its
+        // cost per call once per batch.
+        template<typename Callback>
+          Iterator<Container> & for_each_batch(std::size_t n, Callback callback) &
+          {
+            JMIXIN_TRACE("for_each_batch");
+
+            using value_type = std::ranges::range_value_t<Container>;
+
+            std::vector<value_type> buffer;
+
+            for (auto chunk : chunk_views(std::as_const(*this), n)) {
+              callback(batch_view(chunk, buffer));
             }
 
-            container->insert(std::begin(*container), item);
+            return *this;
+          }
+
+        template<typename Callback>
+          Iterator<Container> && for_each_batch(std::size_t n, Callback callback) &&
+          {
+            return std::move(for_each_batch(n, std::move(callback)));
+          }
+
+        // The batches are split among the workers, each one with its own
+        // buffer when one is needed.
+        template<typename Callback, typename ExecutionPolicy>
+          Iterator<Container> & for_each_batch(ExecutionPolicy &&policy, std::size_t n, Callback callback) &
+          {
+            JMIXIN_TRACE("for_each_batch(par)");
+
+            using value_type = std::ranges::range_value_t<Container>;
+
+            auto views = chunk_views(std::as_const(*this), n);
+
+            parallel::for_each_chunk(policy, views.size(), std::min(views.size(), parallel::concurrency(policy)), [&views, &callback](std::size_t, std::size_t begin, std::size_t end) {
+                std::vector<value_type> buffer;
+
+                for (std::size_t i=begin; i<end; i++) {
+                  callback(batch_view(views[i], buffer));
+                }
+            });
+
+            return *this;
+          }
+
+        template<typename Callback, typename ExecutionPolicy>
+          Iterator<Container> && for_each_batch(ExecutionPolicy &&policy, std::size_t n, Callback callback) &&
+          {
+            return std::move(for_each_batch(std::forward<ExecutionPolicy>(policy), n, std::move(callback)));
+          }
+
+        Iterator<std::vector<Container>> breaks(std::size_t n) const
+        {
+          JMIXIN_TRACE("breaks");
+
+          std::vector<Container> result;
+
+          for (auto chunk : chunk_views(*this, n)) {
+            result.push_back(make_like<Container>(*this, std::begin(chunk), std::end(chunk)));
           }
 
-          return Iterator<std::vector<Container>>{result};
+          JMIXIN_TRACE_OUTPUT(result);
+
+          return Iterator<std::vector<Container>>{std::move(result)};
         }
 
         template<typename Predicate>
           Iterator<std::vector<Container>> partition(Predicate predicate)
           {
+            JMIXIN_TRACE("partition");
+
             std::vector<Container> result;
 
-            result.push_back({});
-            result.push_back({});
+            result.push_back(make_like<Container>(*this));
+            result.push_back(make_like<Container>(*this));
 
             auto it = std::partition(std::begin(*this), std::end(*this), predicate);
 
             std::copy(std::begin(*this), it, std::inserter(result[0], std::end(result[0])));
             std::copy(it, std::end(*this), std::inserter(result[1], std::end(result[1])));
 
-            return Iterator<std::vector<Container>>{result};
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<std::vector<Container>>{std::move(result)};
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Predicate, typename ExecutionPolicy>
           Iterator<std::vector<Container>> partition(ExecutionPolicy &&policy, Predicate predicate)
           {
+            JMIXIN_TRACE("partition(par)");
+
             std::vector<Container> result;
 
-            result.push_back({});
-            result.push_back({});
+            result.push_back(make_like<Container>(*this));
+            result.push_back(make_like<Container>(*this));
+
+            auto it = parallel::partition(policy, std::begin(*this), std::end(*this), predicate);
 
-            auto it = std::partition(policy, std::begin(*this), std::end(*this), predicate);
+            parallel::copy(policy, std::begin(*this), it, result[0]);
+            parallel::copy(policy, it, std::end(*this), result[1]);
 
-            std::copy(policy, std::begin(*this), it, std::inserter(result[0], std::end(result[0])));
-            std::copy(policy, it, std::end(*this), std::inserter(result[1], std::end(result[1])));
+            JMIXIN_TRACE_OUTPUT(result);
 
-            return Iterator<std::vector<Container>>{result};
+            return Iterator<std::vector<Container>>{std::move(result)};
           }
-#endif
+
+        // Partitions the items in place, the ones for which predicate holds
+        // first, and returns views of both parts over the same storage, so
+        // nothing is copied. The views are valid while this container is.
+        template<typename Predicate>
+          auto partition_view(Predicate predicate) &
+          {
+            JMIXIN_TRACE("partition_view");
+
+            auto it = std::partition(std::begin(*this), std::end(*this), predicate);
+
+            return std::pair{std::ranges::subrange(std::begin(*this), it), std::ranges::subrange(it, std::end(*this))};
+          }
+
+        template<typename Predicate>
+          void partition_view(Predicate predicate) && = delete;
+
+        template<typename Predicate, typename ExecutionPolicy>
+          auto partition_view(ExecutionPolicy &&policy, Predicate predicate) &
+          {
+            JMIXIN_TRACE("partition_view(par)");
+
+            auto it = parallel::partition(policy, std::begin(*this), std::end(*this), predicate);
+
+            return std::pair{std::ranges::subrange(std::begin(*this), it), std::ranges::subrange(it, std::end(*this))};
+          }
+
+        template<typename Predicate, typename ExecutionPolicy>
+          void partition_view(ExecutionPolicy &&policy, Predicate predicate) && = delete;
 
         template<typename Predicate>
           Iterator<std::vector<Container>> stable_partition(Predicate predicate)
           {
+            JMIXIN_TRACE("stable_partition");
+
             std::vector<Container> result;
 
-            result.push_back({});
-            result.push_back({});
+            result.push_back(make_like<Container>(*this));
+            result.push_back(make_like<Container>(*this));
 
             auto it = std::stable_partition(std::begin(*this), std::end(*this), predicate);
 
             std::copy(std::begin(*this), it, std::inserter(result[0], std::end(result[0])));
             std::copy(it, std::end(*this), std::inserter(result[1], std::end(result[1])));
 
-            return Iterator<std::vector<Container>>{result};
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return Iterator<std::vector<Container>>{std::move(result)};
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
         template<typename Predicate, typename ExecutionPolicy>
           Iterator<std::vector<Container>> stable_partition(ExecutionPolicy &&policy, Predicate predicate)
           {
+            JMIXIN_TRACE("stable_partition(par)");
+
             std::vector<Container> result;
 
-            result.push_back({});
-            result.push_back({});
+            result.push_back(make_like<Container>(*this));
+            result.push_back(make_like<Container>(*this));
+
+            auto it = parallel::stable_partition(policy, std::begin(*this), std::end(*this), predicate);
 
-            auto it = std::stable_partition(policy, std::begin(*this), std::end(*this), predicate);
+            parallel::copy(policy, std::begin(*this), it, result[0]);
+            parallel::copy(policy, it, std::end(*this), result[1]);
 
-            std::copy(policy, std::begin(*this), it, std::inserter(result[0], std::end(result[0])));
-            std::copy(policy, it, std::end(*this), std::inserter(result[1], std::end(result[1])));
+            JMIXIN_TRACE_OUTPUT(result);
 
-            return Iterator<std::vector<Container>>{result};
+            return Iterator<std::vector<Container>>{std::move(result)};
           }
-#endif
 
         Iterator<typename Container::value_type> flatten() const
         {
-          typename Container::value_type result;
+          JMIXIN_TRACE("flatten");
 
-          for (const auto &item : *this) {
-            for (const auto &value : item) {
-              result.push_back(value);
-            }
-          }
+          using Inner = typename Container::value_type;
 
-          return result;
-        }
+          // the output shares the allocator of the nested containers
+          Inner result = std::empty(*this) == true ? Inner() : make_like<Inner>(*std::begin(*this));
 
-#ifdef JMIXIN_JITERATOR_EXTRA
+          if constexpr (requires { result.reserve(std::size_t{}); }) {
+            std::size_t total = 0;
 
-        template<typename Initial>
-          typename Container::value_type sum(Initial initial = Initial()) const
-          {
-            return std::reduce(std::begin(*this), std::end(*this), initial);
-          }
+            for (const auto &item : *this) {
+              total += std::size(item);
+            }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
-        template<typename Initial, typename ExecutionPolicy>
-          typename Container::value_type sum(ExecutionPolicy &&policy, Initial initial) const
-          {
-            return std::reduce(policy, std::begin(*this), std::end(*this), initial);
+            result.reserve(total);
           }
-#endif
 
-        template<typename Initial>
-          typename Container::value_type product(Initial initial = Initial()) const
-          {
-            return std::reduce(std::begin(*this), std::end(*this), initial, std::multiplies<typename Container::value_type>());
+          for (const auto &item : *this) {
+            result.insert(std::end(result), std::begin(item), std::end(item));
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
-        template<typename Initial, typename ExecutionPolicy>
-          typename Container::value_type product(ExecutionPolicy &&policy, Initial initial) const
-          {
-            return std::reduce(policy, std::begin(*this), std::end(*this), initial, std::multiplies<typename Container::value_type>());
-          }
-#endif
+          JMIXIN_TRACE_OUTPUT(result);
 
-        template<typename Predicate, typename Initial>
-          std::optional<Initial> zip(Predicate predicate, Initial value = Initial()) const
-          {
-            return std::reduce(std::begin(*this), std::end(*this), value, predicate);
-          }
+          return result;
+        }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
-        template<typename Predicate, typename Initial, typename ExecutionPolicy>
-          std::optional<Initial> zip(ExecutionPolicy &&policy, Predicate predicate, Initial value) const
+        // The inner sizes are turned in output offsets with an exclusive prefix
+        // sum, then the output is split evenly among the workers, each one
+        // copying the parts of the segments that fall in its range.
+        template<typename ExecutionPolicy>
+          Iterator<typename Container::value_type> flatten(ExecutionPolicy &&policy) const
           {
-            return std::reduce(policy, std::begin(*this), std::end(*this), value, predicate);
-          }
-#endif
+            JMIXIN_TRACE("flatten(par)");
 
-        template<typename Callback>
-          Iterator<Container> & for_each_n(std::size_t n, Callback callback, std::function<void()> begin = nullptr, std::function<void()> end = nullptr)
-          {
-            if (begin) {
-              begin();
-            }
+            using Inner = typename Container::value_type;
+
+            if constexpr (std::random_access_iterator<typename Container::const_iterator> and parallel::is_indexable_v<Inner>) {
+              std::vector<std::size_t> offsets(std::size(*this) + 1, 0);
+
+              std::transform(std::begin(*this), std::end(*this), std::begin(offsets), [](const auto &item) {
+                  return std::size(item);
+              });
+
+              std::exclusive_scan(std::begin(offsets), std::end(offsets), std::begin(offsets), std::size_t{0});
+
+              std::size_t total = offsets.back();
+
+              Inner result = std::empty(*this) == true ? Inner() : make_like<Inner>(*std::begin(*this), total);
+
+              parallel::for_each_chunk(policy, total, parallel::chunks(policy, total), [&](std::size_t, std::size_t begin, std::size_t end) {
+                  std::size_t i = std::upper_bound(std::begin(offsets), std::end(offsets), begin) - std::begin(offsets) - 1;
+
+                  for (; begin < end; i++) {
+                    std::size_t last = std::min(end, offsets[i + 1]);
+
+                    std::copy_n(std::next(std::begin((*this)[i]), begin - offsets[i]), last - begin, std::begin(result) + begin);
+
+                    begin = last;
+                  }
+              });
+
+              JMIXIN_TRACE_OUTPUT(result);
+
+              return result;
+            } else {
+              return flatten();
+            }
+          }
+
+        // The items of the nested containers, which must be sorted, in order.
+        // All of them are merged at once by a loser tree, so an item costs
+        // log2(k) comparisons, instead of being copied again by every pairwise
+        // merge.
+        template<typename Compare = std::less<>>
+          requires (!parallel::is_policy_v<Compare>)
+          Iterator<typename Container::value_type> merge_all(Compare compare = Compare()) const
+          {
+            JMIXIN_TRACE("merge_all");
+
+            using Inner = typename Container::value_type;
+
+            Inner result = std::empty(*this) == true ? Inner() : make_like<Inner>(*std::begin(*this));
+
+            if constexpr (requires { result.reserve(std::size_t{}); }) {
+              result.reserve(total_size());
+            }
+
+            jmixin::merge_runs(sorted_runs(*this), std::inserter(result, std::end(result)), compare);
+
+            JMIXIN_TRACE_OUTPUT(result);
+
+            return result;
+          }
+
+        // The runs are cut at the same splitter keys and the parts are merged
+        // at the same time into their own slices of the output.
+        template<typename ExecutionPolicy, typename Compare = std::less<>>
+          requires parallel::is_policy_v<ExecutionPolicy>
+          Iterator<typename Container::value_type> merge_all(ExecutionPolicy &&policy, Compare compare = Compare()) const
+          {
+            JMIXIN_TRACE("merge_all(par)");
+
+            using Inner = typename Container::value_type;
+
+            if constexpr (std::random_access_iterator<typename Inner::const_iterator> and parallel::is_indexable_v<Inner>) {
+              Inner result = std::empty(*this) == true ? Inner() : make_like<Inner>(*std::begin(*this), total_size());
+
+              parallel::merge_runs(policy, sorted_runs(*this), std::begin(result), compare);
+
+              JMIXIN_TRACE_OUTPUT(result);
+
+              return result;
+            } else {
+              return merge_all(compare);
+            }
+          }
+
+        // A lazy view of merge_all(): the items are yielded one at a time as
+        // the loser tree produces them, so a terminal can stop early.
+        template<typename Compare = std::less<>>
+          auto merge_view(Compare compare = Compare()) const &
+          {
+            return jmixin::lazy<typename Container::value_type::value_type>([this, compare](auto &sink) {
+                merge_items(sink, *this, compare);
+            });
+          }
+
+        template<typename Compare = std::less<>>
+          auto merge_view(Compare compare = Compare()) &&
+          {
+            return jmixin::lazy<typename Container::value_type::value_type>([container=Container(std::move(*this)), compare](auto &sink) {
+                merge_items(sink, container, compare);
+            });
+          }
+
+#ifdef JMIXIN_JITERATOR_EXTRA
+
+        template<typename Initial>
+          typename Container::value_type sum(Initial initial = Initial()) const
+          {
+            JMIXIN_TRACE("sum");
+
+            if constexpr (simd::is_simd_range_v<Container> and std::is_same_v<Initial, typename Container::value_type>) {
+              return initial + simd::sum(std::data(*this), std::size(*this));
+            }
+
+            return std::reduce(std::begin(*this), std::end(*this), initial);
+          }
+
+        template<typename Initial, typename ExecutionPolicy>
+          typename Container::value_type sum(ExecutionPolicy &&policy, Initial initial) const
+          {
+            JMIXIN_TRACE("sum(par)");
+
+            return parallel::reduce(policy, std::begin(*this), std::end(*this), initial, std::plus<>());
+          }
+
+        template<typename Initial>
+          typename Container::value_type product(Initial initial = Initial()) const
+          {
+            JMIXIN_TRACE("product");
+
+            if constexpr (simd::is_simd_range_v<Container> and std::is_same_v<Initial, typename Container::value_type>) {
+              return initial * simd::product(std::data(*this), std::size(*this));
+            }
+
+            return std::reduce(std::begin(*this), std::end(*this), initial, std::multiplies<typename Container::value_type>());
+          }
+
+        template<typename Initial, typename ExecutionPolicy>
+          typename Container::value_type product(ExecutionPolicy &&policy, Initial initial) const
+          {
+            JMIXIN_TRACE("product(par)");
+
+            return parallel::reduce(policy, std::begin(*this), std::end(*this), initial, std::multiplies<typename Container::value_type>());
+          }
+
+        template<typename Predicate, typename Initial>
+          std::optional<Initial> zip(Predicate predicate, Initial value = Initial()) const
+          {
+            JMIXIN_TRACE("zip");
+
+            if constexpr (simd::is_simd_range_v<Container> and simd::is_reducible_v<typename Container::const_iterator, Initial, Predicate>) {
+              return simd::reduce(std::data(*this), std::size(*this), value, predicate);
+            }
+
+            return std::reduce(std::begin(*this), std::end(*this), value, predicate);
+          }
+
+        template<typename Predicate, typename Initial, typename ExecutionPolicy>
+          std::optional<Initial> zip(ExecutionPolicy &&policy, Predicate predicate, Initial value) const
+          {
+            JMIXIN_TRACE("zip(par)");
+
+            return parallel::reduce(policy, std::begin(*this), std::end(*this), value, predicate);
+          }
+
+        template<typename Callback>
+          Iterator<Container> & for_each_n(std::size_t n, Callback callback, std::function<void()> begin = nullptr, std::function<void()> end = nullptr) &
+          {
+            JMIXIN_TRACE("for_each_n");
+
+            if (begin) {
+              begin();
+            }
 
             std::for_each_n(std::begin(*this), n, callback);
 
@@ -1138,15 +2359,22 @@ namespace jmixin {
             return *this;
           }
 
-#ifdef JMIXIN_JITERATOR_PARALLEL
+        template<typename Callback>
+          Iterator<Container> && for_each_n(std::size_t n, Callback callback, std::function<void()> begin = nullptr, std::function<void()> end = nullptr) &&
+          {
+            return std::move(for_each_n(n, std::move(callback), std::move(begin), std::move(end)));
+          }
+
         template<typename Callback, typename ExecutionPolicy>
-          Iterator<Container> & for_each_n(ExecutionPolicy &&policy, std::size_t n, Callback callback, std::function<void()> begin, std::function<void()> end)
+          Iterator<Container> & for_each_n(ExecutionPolicy &&policy, std::size_t n, Callback callback, std::function<void()> begin, std::function<void()> end) &
           {
+            JMIXIN_TRACE("for_each_n(par)");
+
             if (begin) {
               begin();
             }
 
-            std::for_each_n(policy, std::begin(*this), n, callback);
+            parallel::for_each_n(policy, std::begin(*this), n, callback);
 
             if (end) {
               end();
@@ -1154,10 +2382,987 @@ namespace jmixin {
 
             return *this;
           }
-#endif
+
+        template<typename Callback, typename ExecutionPolicy>
+          Iterator<Container> && for_each_n(ExecutionPolicy &&policy, std::size_t n, Callback callback, std::function<void()> begin, std::function<void()> end) &&
+          {
+            return std::move(for_each_n(std::forward<ExecutionPolicy>(policy), n, std::move(callback), std::move(begin), std::move(end)));
+          }
 
 #endif
 
+      private:
+        auto lazy_allocator() const
+        {
+          if constexpr (requires { typename Container::allocator_type; }) {
+            if constexpr (is_owning_allocator_v<typename Container::allocator_type>) {
+              return this->get_allocator();
+            } else {
+              return std::allocator<typename Container::value_type>();
+            }
+          } else {
+            return std::allocator<typename Container::value_type>();
+          }
+        }
+
+        template<typename Sink, typename ...Ranges>
+          static void zip_items(Sink &sink, std::size_t n, const Ranges &...ranges)
+          {
+            using Item = std::tuple<std::ranges::range_reference_t<const Ranges>...>;
+
+            auto iterators = std::make_tuple(std::ranges::begin(ranges)...);
+
+            for (std::size_t i=0; i<n; i++) {
+              bool next = std::apply([&sink](auto &...iterator) {
+                  return sink(Item(*iterator...));
+              }, iterators);
+
+              if (next == false) {
+                break;
+              }
+
+              std::apply([](auto &...iterator) {
+                  (++iterator, ...);
+              }, iterators);
+            }
+          }
+
+        // The [begin, end) pairs of the nested containers, skipping the empty ones.
+        static auto sorted_runs(const Container &container)
+        {
+          using Inner = typename Container::value_type;
+
+          std::vector<std::pair<typename Inner::const_iterator, typename Inner::const_iterator>> runs;
+
+          for (const auto &item : container) {
+            if (std::empty(item) == false) {
+              runs.emplace_back(std::begin(item), std::end(item));
+            }
+          }
+
+          return runs;
+        }
+
+        std::size_t total_size() const
+        {
+          std::size_t total = 0;
+
+          for (const auto &item : *this) {
+            total += std::size(item);
+          }
+
+          return total;
+        }
+
+        template<typename Sink, typename Compare>
+          static void merge_items(Sink &sink, const Container &container, const Compare &compare)
+          {
+            LoserTree tree(sorted_runs(container), compare);
+
+            for (; tree.empty() == false; tree.pop()) {
+              if (sink(tree.top()) == false) {
+                break;
+              }
+            }
+          }
+
+        template<typename Range>
+          using chunk_type = std::conditional_t<std::ranges::contiguous_range<Range>,
+                std::span<std::remove_reference_t<std::ranges::range_reference_t<Range>>>,
+                std::ranges::subrange<std::ranges::iterator_t<Range>>>;
+
+        template<typename Range>
+          static std::vector<chunk_type<Range>> chunk_views(Range &range, std::size_t n)
+          {
+            if (n == 0) {
+              throw std::runtime_error("Chunk size must be greater than zero");
+            }
+
+            std::vector<chunk_type<Range>> result;
+
+            result.reserve((std::size(range) + n - 1)/n);
+
+            auto first = std::ranges::begin(range);
+            auto last = std::ranges::end(range);
+
+            while (first != last) {
+              auto next = std::ranges::next(first, static_cast<std::ranges::range_difference_t<Range>>(n), last);
+
+              result.emplace_back(first, next);
+
+              first = next;
+            }
+
+            return result;
+          }
+
+        using hash_key_type = std::remove_cvref_t<std::ranges::range_value_t<Container>>;
+
+        static auto sequential_probe()
+        {
+          return [](const auto &range, auto f) {
+            for (const auto &item : range) {
+              f(item);
+            }
+          };
+        }
+
+        template<typename ExecutionPolicy>
+          static auto parallel_probe(ExecutionPolicy &policy)
+          {
+            return [&policy](const auto &range, auto f) {
+              parallel::probe(policy, range, f);
+            };
+          }
+
+        // Which keys of set appear in range.
+        template<typename Range, typename Probe>
+          static std::vector<std::atomic<bool>> hash_found(const FlatHashSet<hash_key_type> &keys, const Range &range, Probe probe)
+          {
+            std::vector<std::atomic<bool>> result(keys.size());
+
+            probe(range, [&](const auto &item) {
+                std::size_t i = keys.index(item);
+
+                if (i != keys.size()) {
+                  result[i].store(true, std::memory_order_relaxed);
+                }
+            });
+
+            return result;
+          }
+
+        template<typename Container2, typename Probe, typename Apply>
+          Iterator<Container> & hash_filter(const Container2 &other, bool in, Probe probe, Apply apply)
+          {
+            if (std::size(other) <= std::size(*this)) {
+              auto keys = make_set<hash_key_type>(other);
+
+              apply([&keys, in](const auto &item) {
+                  return keys.contains(item) == in;
+              });
+            } else {
+              auto keys = make_set<hash_key_type>(*this);
+              auto marks = hash_found(keys, other, probe);
+
+              apply([&keys, &marks, in](const auto &item) {
+                  return marks[keys.index(item)].load(std::memory_order_relaxed) == in;
+              });
+            }
+
+            return *this;
+          }
+
+        // Only the probes run in parallel, the inserts are sequential.
+        template<typename Container2, typename Probe>
+          Iterator<Container> & hash_append(const Container2 &other, Probe probe)
+          {
+            if (std::size(other) <= std::size(*this)) {
+              auto keys = make_set<hash_key_type>(other);
+              auto marks = hash_found(keys, static_cast<const Container &>(*this), probe);
+              auto key = std::begin(keys);
+
+              for (std::size_t i=0; i<marks.size(); i++, ++key) {
+                if (marks[i].load(std::memory_order_relaxed) == false) {
+                  this->insert(std::end(*this), *key);
+                }
+              }
+            } else {
+              auto keys = make_set<hash_key_type>(*this);
+
+              for (const auto &item : other) {
+                if (keys.insert(item).second == true) {
+                  this->insert(std::end(*this), item);
+                }
+              }
+            }
+
+            return *this;
+          }
+
+        template<typename Container2, typename Probe>
+          bool hash_covers(const Container2 &other, Probe probe) const
+          {
+            if (std::size(other) <= std::size(*this)) {
+              auto keys = make_set<hash_key_type>(other);
+              auto marks = hash_found(keys, static_cast<const Container &>(*this), probe);
+
+              return std::all_of(std::begin(marks), std::end(marks), [](const auto &mark) {
+                  return mark.load(std::memory_order_relaxed);
+              });
+            }
+
+            auto keys = make_set<hash_key_type>(*this);
+            std::atomic<bool> missing {false};
+
+            probe(other, [&](const auto &item) {
+                if (keys.contains(item) == false) {
+                  missing.store(true, std::memory_order_relaxed);
+                }
+            });
+
+            return missing.load() == false;
+          }
+
+        // buffer is only filled when chunk is not contiguous, item by item as
+        // the items may have const members (the pairs of a map)
+        template<typename Chunk, typename Value>
+          static std::span<const Value> batch_view(const Chunk &chunk, std::vector<Value> &buffer)
+          {
+            if constexpr (std::ranges::contiguous_range<Chunk>) {
+              return std::span<const Value>(std::ranges::data(chunk), std::ranges::size(chunk));
+            } else {
+              buffer.clear();
+
+              for (const auto &item : chunk) {
+                buffer.emplace_back(item);
+              }
+
+              return std::span<const Value>(buffer);
+            }
+          }
+
+    };
+
+  // An Iterator whose items are ordered by compare. The set operations
+  // keep that ordering, so they return a SortedIterator again and only
+  // validate their inputs in debug builds. The mutators that could break
+  // the ordering are shadowed below.
+  template<typename Container, typename Compare>
+    class SortedIterator : public Iterator<Container> {
+
+      public:
+        SortedIterator() = default;
+
+        SortedIterator(const Iterator<Container> &items, Compare compare = Compare()):
+          Iterator<Container>(static_cast<const Container &>(items)), _compare(std::move(compare))
+        {
+          check(*this);
+        }
+
+        SortedIterator(Iterator<Container> &&items, Compare compare = Compare()):
+          Iterator<Container>(std::move(items)), _compare(std::move(compare))
+        {
+          check(*this);
+        }
+
+        const Compare & compare() const
+        {
+          return _compare;
+        }
+
+        template<typename T>
+          typename Container::const_iterator lower_bound(const T &value) const
+          {
+            JMIXIN_TRACE("lower_bound");
+
+            if constexpr (is_native_v<T>) {
+              return Container::lower_bound(value);
+            } else {
+              return std::lower_bound(std::begin(*this), std::end(*this), value, _compare);
+            }
+          }
+
+        template<typename T>
+          std::ranges::subrange<typename Container::const_iterator> equal_range(const T &value) const
+          {
+            JMIXIN_TRACE("equal_range");
+
+            if constexpr (is_native_v<T>) {
+              auto [first, last] = Container::equal_range(value);
+
+              return {first, last};
+            } else {
+              auto [first, last] = std::equal_range(std::begin(*this), std::end(*this), value, _compare);
+
+              return {first, last};
+            }
+          }
+
+        template<typename T>
+          bool contains(const T &value) const
+          {
+            JMIXIN_TRACE("contains");
+
+            auto i = lower_bound(value);
+
+            return i != std::end(*this) and _compare(value, *i) == false;
+          }
+
+        SortedIterator<Container, Compare> & unique() &
+        {
+          JMIXIN_TRACE("unique");
+
+          check(*this);
+
+          this->erase(std::unique(std::begin(*this), std::end(*this), equivalent()), std::end(*this));
+
+          return *this;
+        }
+
+        SortedIterator<Container, Compare> && unique() &&
+        {
+          return std::move(unique());
+        }
+
+        template<typename ExecutionPolicy>
+          SortedIterator<Container, Compare> & unique(ExecutionPolicy &&policy) &
+          {
+            JMIXIN_TRACE("unique(par)");
+
+            check(*this);
+
+            this->erase(parallel::unique(policy, std::begin(*this), std::end(*this), equivalent()), std::end(*this));
+
+            return *this;
+          }
+
+        template<typename ExecutionPolicy>
+          SortedIterator<Container, Compare> && unique(ExecutionPolicy &&policy) &&
+          {
+            return std::move(unique(std::forward<ExecutionPolicy>(policy)));
+          }
+
+        template<typename Container2>
+          bool includes(const Container2 &other) const
+          {
+            JMIXIN_TRACE("includes");
+
+            check(*this);
+            check(other);
+
+            return std::includes(std::begin(*this), std::end(*this), std::begin(other), std::end(other), _compare);
+          }
+
+        template<typename Container2,typename ExecutionPolicy>
+          bool includes(ExecutionPolicy &&policy, const Container2 &other) const
+          {
+            JMIXIN_TRACE("includes(par)");
+
+            check(*this);
+            check(other);
+
+            return parallel::includes(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), _compare);
+          }
+
+        template<typename Container2>
+          SortedIterator<Container, Compare> & difference(const Container2 &other) &
+          {
+            JMIXIN_TRACE("difference");
+
+            check(*this);
+            check(other);
+
+            Container result = make_like<Container>(*this);
+
+            std::set_difference(std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)), _compare);
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Container2>
+          SortedIterator<Container, Compare> && difference(const Container2 &other) &&
+          {
+            return std::move(difference(other));
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          SortedIterator<Container, Compare> & difference(ExecutionPolicy &&policy, const Container2 &other) &
+          {
+            JMIXIN_TRACE("difference(par)");
+
+            check(*this);
+            check(other);
+
+            Container result = make_like<Container>(*this);
+
+            if constexpr (parallel::is_indexable_v<Container>) {
+              result.resize(std::size(*this));
+
+              result.erase(parallel::set_difference(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::begin(result), _compare), std::end(result));
+            } else {
+              parallel::set_difference(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)), _compare);
+            }
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          SortedIterator<Container, Compare> && difference(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(difference(std::forward<ExecutionPolicy>(policy), other));
+          }
+
+        template<typename Container2>
+          SortedIterator<Container, Compare> & complement(const Container2 &other) &
+          {
+            JMIXIN_TRACE("complement");
+
+            check(*this);
+            check(other);
+
+            Container result = make_like<Container>(*this);
+
+            std::set_difference(std::begin(other), std::end(other), std::begin(*this), std::end(*this), std::inserter(result, std::end(result)), _compare);
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Container2>
+          SortedIterator<Container, Compare> && complement(const Container2 &other) &&
+          {
+            return std::move(complement(other));
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          SortedIterator<Container, Compare> & complement(ExecutionPolicy &&policy, const Container2 &other) &
+          {
+            JMIXIN_TRACE("complement(par)");
+
+            check(*this);
+            check(other);
+
+            Container result = make_like<Container>(*this);
+
+            if constexpr (parallel::is_indexable_v<Container>) {
+              result.resize(std::size(other));
+
+              result.erase(parallel::set_difference(policy, std::begin(other), std::end(other), std::begin(*this), std::end(*this), std::begin(result), _compare), std::end(result));
+            } else {
+              parallel::set_difference(policy, std::begin(other), std::end(other), std::begin(*this), std::end(*this), std::inserter(result, std::end(result)), _compare);
+            }
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          SortedIterator<Container, Compare> && complement(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(complement(std::forward<ExecutionPolicy>(policy), other));
+          }
+
+        template<typename Container2>
+          SortedIterator<Container, Compare> & intersection(const Container2 &other) &
+          {
+            JMIXIN_TRACE("intersection");
+
+            check(*this);
+            check(other);
+
+            Container result = make_like<Container>(*this);
+
+            std::set_intersection(std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)), _compare);
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Container2>
+          SortedIterator<Container, Compare> && intersection(const Container2 &other) &&
+          {
+            return std::move(intersection(other));
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          SortedIterator<Container, Compare> & intersection(ExecutionPolicy &&policy, const Container2 &other) &
+          {
+            JMIXIN_TRACE("intersection(par)");
+
+            check(*this);
+            check(other);
+
+            Container result = make_like<Container>(*this);
+
+            if constexpr (parallel::is_indexable_v<Container>) {
+              result.resize(std::min<std::size_t>(std::size(*this), std::size(other)));
+
+              result.erase(parallel::set_intersection(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::begin(result), _compare), std::end(result));
+            } else {
+              parallel::set_intersection(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)), _compare);
+            }
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          SortedIterator<Container, Compare> && intersection(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(intersection(std::forward<ExecutionPolicy>(policy), other));
+          }
+
+        template<typename Container2>
+          SortedIterator<Container, Compare> & union_set(const Container2 &other) &
+          {
+            JMIXIN_TRACE("union_set");
+
+            check(*this);
+            check(other);
+
+            Container result = make_like<Container>(*this);
+
+            std::set_union(std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)), _compare);
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Container2>
+          SortedIterator<Container, Compare> && union_set(const Container2 &other) &&
+          {
+            return std::move(union_set(other));
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          SortedIterator<Container, Compare> & union_set(ExecutionPolicy &&policy, const Container2 &other) &
+          {
+            JMIXIN_TRACE("union_set(par)");
+
+            check(*this);
+            check(other);
+
+            Container result = make_like<Container>(*this);
+
+            if constexpr (parallel::is_indexable_v<Container>) {
+              result.resize(std::size(*this) + std::size(other));
+
+              result.erase(parallel::set_union(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::begin(result), _compare), std::end(result));
+            } else {
+              parallel::set_union(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)), _compare);
+            }
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          SortedIterator<Container, Compare> && union_set(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(union_set(std::forward<ExecutionPolicy>(policy), other));
+          }
+
+        template<typename Container2>
+          SortedIterator<Container, Compare> & merge(const Container2 &other) &
+          {
+            JMIXIN_TRACE("merge");
+
+            check(*this);
+            check(other);
+
+            Container result = make_like<Container>(*this);
+
+            std::merge(std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)), _compare);
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Container2>
+          SortedIterator<Container, Compare> && merge(const Container2 &other) &&
+          {
+            return std::move(merge(other));
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          SortedIterator<Container, Compare> & merge(ExecutionPolicy &&policy, const Container2 &other) &
+          {
+            JMIXIN_TRACE("merge(par)");
+
+            check(*this);
+            check(other);
+
+            Container result = make_like<Container>(*this);
+
+            if constexpr (parallel::is_indexable_v<Container>) {
+              result.resize(std::size(*this) + std::size(other));
+
+              parallel::merge(policy, std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::begin(result), _compare);
+            } else {
+              std::merge(std::begin(*this), std::end(*this), std::begin(other), std::end(other), std::inserter(result, std::end(result)), _compare);
+            }
+
+            Container::swap(result);
+
+            return *this;
+          }
+
+        template<typename Container2, typename ExecutionPolicy>
+          SortedIterator<Container, Compare> && merge(ExecutionPolicy &&policy, const Container2 &other) &&
+          {
+            return std::move(merge(std::forward<ExecutionPolicy>(policy), other));
+          }
+
+        // The operations that keep the order of the items return the
+        // SortedIterator again. The callbacks of for_each must not change the
+        // order of the items.
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & filter(Args &&...args) &
+          {
+            Iterator<Container>::filter(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && filter(Args &&...args) &&
+          {
+            return std::move(filter(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & step(Args &&...args) &
+          {
+            Iterator<Container>::step(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && step(Args &&...args) &&
+          {
+            return std::move(step(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & skip(Args &&...args) &
+          {
+            Iterator<Container>::skip(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && skip(Args &&...args) &&
+          {
+            return std::move(skip(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & take(Args &&...args) &
+          {
+            Iterator<Container>::take(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && take(Args &&...args) &&
+          {
+            return std::move(take(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & chop(Args &&...args) &
+          {
+            Iterator<Container>::chop(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && chop(Args &&...args) &&
+          {
+            return std::move(chop(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & hash_intersection(Args &&...args) &
+          {
+            Iterator<Container>::hash_intersection(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && hash_intersection(Args &&...args) &&
+          {
+            return std::move(hash_intersection(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & hash_difference(Args &&...args) &
+          {
+            Iterator<Container>::hash_difference(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && hash_difference(Args &&...args) &&
+          {
+            return std::move(hash_difference(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & for_each(Args &&...args) &
+          {
+            Iterator<Container>::for_each(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && for_each(Args &&...args) &&
+          {
+            return std::move(for_each(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & for_each_n(Args &&...args) &
+          {
+            Iterator<Container>::for_each_n(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && for_each_n(Args &&...args) &&
+          {
+            return std::move(for_each_n(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & for_each_chunk(Args &&...args) &
+          {
+            Iterator<Container>::for_each_chunk(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && for_each_chunk(Args &&...args) &&
+          {
+            return std::move(for_each_chunk(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> & for_each_batch(Args &&...args) &
+          {
+            Iterator<Container>::for_each_batch(std::forward<Args>(args)...);
+
+            return *this;
+          }
+
+        template<typename ...Args>
+          SortedIterator<Container, Compare> && for_each_batch(Args &&...args) &&
+          {
+            return std::move(for_each_batch(std::forward<Args>(args)...));
+          }
+
+        // The operations that may break the order are not available on an
+        // lvalue; on an rvalue they give its items back as a plain Iterator.
+        template<typename ...Args>
+          void sort(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          auto sort(Args &&...args) &&
+          {
+            return static_cast<Iterator<Container> &&>(*this).sort(std::forward<Args>(args)...);
+          }
+
+        template<typename ...Args>
+          void partition(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<std::vector<Container>> partition(Args &&...args) &&
+          {
+            return Iterator<Container>::partition(std::forward<Args>(args)...);
+          }
+
+        template<typename ...Args>
+          void stable_partition(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<std::vector<Container>> stable_partition(Args &&...args) &&
+          {
+            return Iterator<Container>::stable_partition(std::forward<Args>(args)...);
+          }
+
+        // the parts would be views over the reordered storage
+        template<typename ...Args>
+          void partition_view(Args &&...args) = delete;
+
+        // read only views, so the chunks can not reorder the items
+        auto chunks(std::size_t n) const &
+        {
+          return Iterator<Container>::chunks(n);
+        }
+
+        auto chunks(std::size_t n) && = delete;
+
+        template<typename ...Args>
+          void append(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> append(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::append(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void prepend(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> prepend(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::prepend(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void fill(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> fill(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::fill(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void fill_n(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> fill_n(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::fill_n(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void generate(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> generate(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::generate(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void reverse(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> reverse(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::reverse(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void shuffle(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> shuffle(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::shuffle(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void left_rotate(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> left_rotate(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::left_rotate(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void right_rotate(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> right_rotate(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::right_rotate(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void swap(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> swap(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::swap(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void combine(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> combine(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::combine(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void hash_union(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> hash_union(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::hash_union(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void sort_by(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> sort_by(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::sort_by(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void top_k(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> top_k(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::top_k(std::forward<Args>(args)...));
+          }
+
+        template<typename ...Args>
+          void bottom_k(Args &&...args) & = delete;
+
+        template<typename ...Args>
+          Iterator<Container> bottom_k(Args &&...args) &&
+          {
+            return std::move(Iterator<Container>::bottom_k(std::forward<Args>(args)...));
+          }
+
+      private:
+        [[no_unique_address]] Compare _compare;
+
+        // associative containers already know how to search themselves
+        template<typename T>
+          static constexpr bool is_native_v = requires (const Container &container, const T &value) {
+            requires std::is_same_v<Compare, std::less<>> or std::is_same_v<Compare, typename Container::key_compare>;
+
+            container.lower_bound(value);
+            container.equal_range(value);
+          };
+
+        auto equivalent() const
+        {
+          return [compare=_compare](const auto &a, const auto &b) {
+            return compare(a, b) == false and compare(b, a) == false;
+          };
+        }
+
+        template<typename Container2>
+          void check([[maybe_unused]] const Container2 &items) const
+          {
+            assert(std::is_sorted(std::begin(items), std::end(items), _compare) and "Container must be sorted");
+          }
+
     };
 
 }
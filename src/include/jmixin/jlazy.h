@@ -0,0 +1,279 @@
+#pragma once
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "jrandom.h"
+
+namespace jmixin {
+
+  template<typename Container>
+    class Iterator;
+
+  namespace detail {
+
+    struct identity_stage {
+      template<typename Sink>
+        Sink operator()(Sink sink) const
+        {
+          return sink;
+        }
+    };
+
+  }
+
+  // A LazyIterator records the chained stages and only runs them, fused in a
+  // single loop, when a terminal operation is called. A source is a callable
+  // that pushes items into a sink until the sink returns false; a stage wraps
+  // the downstream sink into a new one. The allocator is the one of the
+  // containers built by the terminals (see is_owning_allocator_v).
+  template<typename T, typename Source, typename Stage = detail::identity_stage, typename Allocator = std::allocator<T>>
+    class LazyIterator {
+
+      public:
+        using value_type = T;
+        using allocator_type = Allocator;
+
+        LazyIterator(Source source, Stage stage = Stage(), Allocator allocator = Allocator()):
+          _source(std::move(source)), _stage(std::move(stage)), _allocator(std::move(allocator))
+        {
+        }
+
+        allocator_type get_allocator() const
+        {
+          return _allocator;
+        }
+
+        template<typename Predicate>
+          auto filter(Predicate predicate) &&
+          {
+            return chain<T>([predicate](auto sink) {
+                return [predicate, sink](auto &&item) mutable -> bool {
+                  if (predicate(std::as_const(item)) == false) {
+                    return true;
+                  }
+
+                  return sink(std::forward<decltype(item)>(item));
+                };
+            });
+          }
+
+        template<typename Predicate>
+          auto map(Predicate predicate) &&
+          {
+            using Result = std::decay_t<std::invoke_result_t<Predicate &, const T &>>;
+
+            return chain<Result>([predicate](auto sink) {
+                return [predicate, sink](auto &&item) mutable -> bool {
+                  return sink(predicate(std::as_const(item)));
+                };
+            });
+          }
+
+        auto take(std::size_t n) &&
+        {
+          return chain<T>([n](auto sink) {
+              return [n, i=std::size_t{0}, sink](auto &&item) mutable -> bool {
+                if (i >= n) {
+                  return false;
+                }
+
+                i++;
+
+                if (sink(std::forward<decltype(item)>(item)) == false) {
+                  return false;
+                }
+
+                return i < n;
+              };
+          });
+        }
+
+        auto skip(std::size_t n = 1) &&
+        {
+          return chain<T>([n](auto sink) {
+              return [n, i=std::size_t{0}, sink](auto &&item) mutable -> bool {
+                if (i < n) {
+                  i++;
+
+                  return true;
+                }
+
+                return sink(std::forward<decltype(item)>(item));
+              };
+          });
+        }
+
+        auto step(std::size_t n) &&
+        {
+          return chain<T>([n](auto sink) {
+              return [n, i=std::size_t{0}, sink](auto &&item) mutable -> bool {
+                if ((i++ % n) != 0) {
+                  return true;
+                }
+
+                return sink(std::forward<decltype(item)>(item));
+              };
+          });
+        }
+
+        template<typename Callback>
+          void for_each(Callback callback, std::function<void()> begin = nullptr, std::function<void()> end = nullptr) &&
+          {
+            if (begin) {
+              begin();
+            }
+
+            run([&callback](auto &&item) {
+                callback(std::forward<decltype(item)>(item));
+
+                return true;
+            });
+
+            if (end) {
+              end();
+            }
+          }
+
+        std::size_t count() &&
+        {
+          std::size_t result {0};
+
+          run([&result](auto &&) {
+              result++;
+
+              return true;
+          });
+
+          return result;
+        }
+
+        template<typename Initial = T>
+          Initial sum(Initial initial = Initial()) &&
+          {
+            run([&initial](auto &&item) {
+                initial = initial + item;
+
+                return true;
+            });
+
+            return initial;
+          }
+
+        std::optional<T> first() &&
+        {
+          std::optional<T> result;
+
+          run([&result](auto &&item) {
+              result.emplace(std::forward<decltype(item)>(item));
+
+              return false;
+          });
+
+          return result;
+        }
+
+        template<typename Predicate>
+          std::optional<T> find_first(Predicate predicate) &&
+          {
+            std::optional<T> result;
+
+            run([&result, &predicate](auto &&item) {
+                if (predicate(std::as_const(item)) == true) {
+                  result.emplace(std::forward<decltype(item)>(item));
+
+                  return false;
+                }
+
+                return true;
+            });
+
+            return result;
+          }
+
+        // A uniform sample of up to n items in a single pass, so the source
+        // may be an unbounded or forward only stream that stops by itself.
+        Iterator<std::vector<T, Allocator>> sample(std::size_t n) &&
+        {
+          return std::move(*this).sample(n, default_engine());
+        }
+
+        template<typename URBG>
+          Iterator<std::vector<T, Allocator>> sample(std::size_t n, URBG &&g) &&
+          {
+            random::Reservoir<T, std::remove_reference_t<URBG>> reservoir(n, g);
+
+            run([&reservoir](auto &&item) {
+                reservoir.push(std::forward<decltype(item)>(item));
+
+                return true;
+            });
+
+            auto items = std::move(reservoir).items();
+
+            if constexpr (std::is_same_v<Allocator, std::allocator<T>>) {
+              return Iterator<std::vector<T>>{std::move(items)};
+            } else {
+              return Iterator<std::vector<T, Allocator>>{std::vector<T, Allocator>(std::make_move_iterator(std::begin(items)), std::make_move_iterator(std::end(items)), _allocator)};
+            }
+          }
+
+        template<typename Container = std::vector<T, Allocator>>
+          Iterator<Container> collect() &&
+          {
+            Iterator<Container> result = make_like<Container>(*this);
+
+            run([&result](auto &&item) {
+                result.insert(std::end(result), std::forward<decltype(item)>(item));
+
+                return true;
+            });
+
+            return result;
+          }
+
+      private:
+        Source _source;
+        Stage _stage;
+        Allocator _allocator;
+
+        template<typename Result, typename Wrapper>
+          auto chain(Wrapper wrapper)
+          {
+            using ResultAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Result>;
+
+            auto stage = [previous=std::move(_stage), wrapper=std::move(wrapper)](auto sink) {
+              return previous(wrapper(std::move(sink)));
+            };
+
+            return LazyIterator<Result, Source, decltype(stage), ResultAllocator>(std::move(_source), std::move(stage), ResultAllocator(_allocator));
+          }
+
+        template<typename Sink>
+          void run(Sink sink)
+          {
+            auto head = _stage(std::move(sink));
+
+            _source(head);
+          }
+
+    };
+
+  template<typename T, typename Source>
+    LazyIterator<T, Source> lazy(Source source)
+    {
+      return LazyIterator<T, Source>(std::move(source));
+    }
+
+  template<typename T, typename Source, typename Allocator>
+    LazyIterator<T, Source, detail::identity_stage, Allocator> lazy(Source source, Allocator allocator)
+    {
+      return LazyIterator<T, Source, detail::identity_stage, Allocator>(std::move(source), detail::identity_stage(), std::move(allocator));
+    }
+
+}
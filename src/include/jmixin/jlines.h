@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) or defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JMIXIN_LINES_MMAP
+#endif
+
+#include "jiterator.h"
+
+namespace jmixin {
+
+  // The bytes of a file, mapped in memory when the system can. Files that
+  // report no size (procfs, pipes) and systems without mmap are read into
+  // a buffer instead.
+  class MappedFile {
+
+    public:
+      explicit MappedFile(const std::string &path)
+      {
+#ifdef JMIXIN_LINES_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0) {
+          throw std::runtime_error("Unable to open file '" + path + "'");
+        }
+
+        struct stat info;
+
+        if (::fstat(fd, &info) == 0 and S_ISREG(info.st_mode) and info.st_size > 0) {
+          void *address = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+          if (address != MAP_FAILED) {
+            ::madvise(address, info.st_size, MADV_SEQUENTIAL);
+
+            _data = static_cast<const char *>(address);
+            _size = info.st_size;
+            _mapped = true;
+          }
+        }
+
+        if (_mapped == false) {
+          char block[64*1024];
+          ssize_t n;
+
+          while ((n = ::read(fd, block, sizeof(block))) > 0) {
+            _buffer.append(block, n);
+          }
+
+          _data = _buffer.data();
+          _size = _buffer.size();
+        }
+
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary);
+
+        if (!in) {
+          throw std::runtime_error("Unable to open file '" + path + "'");
+        }
+
+        _buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+        _data = _buffer.data();
+        _size = _buffer.size();
+#endif
+      }
+
+      MappedFile(const MappedFile &) = delete;
+
+      MappedFile & operator=(const MappedFile &) = delete;
+
+      ~MappedFile()
+      {
+#ifdef JMIXIN_LINES_MMAP
+        if (_mapped == true) {
+          ::munmap(const_cast<char *>(_data), _size);
+        }
+#endif
+      }
+
+      const char * data() const
+      {
+        return _data;
+      }
+
+      std::size_t size() const
+      {
+        return _size;
+      }
+
+      bool mapped() const
+      {
+        return _mapped;
+      }
+
+    private:
+      const char *_data {nullptr};
+      std::size_t _size {0};
+      bool _mapped {false};
+      std::string _buffer;
+
+  };
+
+  // Allocates like std::allocator but also holds the file the elements point
+  // into. Every container built from Lines (see make_like) carries it and
+  // so keeps the file alive; it follows the data on assignments and swaps.
+  template<typename T>
+    class MappedAllocator {
+
+      public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::true_type;
+
+        MappedAllocator() = default;
+
+        explicit MappedAllocator(std::shared_ptr<const MappedFile> file):
+          _file(std::move(file))
+        {
+        }
+
+        template<typename U>
+          MappedAllocator(const MappedAllocator<U> &other):
+            _file(other.file())
+          {
+          }
+
+        T * allocate(std::size_t n)
+        {
+          return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T *pointer, std::size_t n)
+        {
+          std::allocator<T>().deallocate(pointer, n);
+        }
+
+        const std::shared_ptr<const MappedFile> & file() const
+        {
+          return _file;
+        }
+
+        template<typename U>
+          bool operator==(const MappedAllocator<U> &) const
+          {
+            return true;
+          }
+
+      private:
+        std::shared_ptr<const MappedFile> _file;
+
+    };
+
+  // only the views point into the file; rebound to other items, as after a
+  // lazy map(), the allocator just comes along
+  template<>
+    inline constexpr bool is_owning_allocator_v<MappedAllocator<std::string_view>> = true;
+
+  using Lines = std::vector<std::string_view, MappedAllocator<std::string_view>>;
+
+  // Splits a file in lines, without the line breaks, as views over its
+  // mapping; a missing line break at the end of the file is not an extra
+  // empty line, as with std::getline. Throws if the file can not be opened.
+  // Copying the views into a container without the MappedAllocator (as
+  // map<std::vector<std::string_view>>) fails to compile, since nothing
+  // would keep the mapping alive.
+  inline Iterator<Lines> lines(const std::string &path)
+  {
+    auto file = std::make_shared<const MappedFile>(path);
+
+    Lines result {MappedAllocator<std::string_view>(file)};
+
+    const char *first = file->data();
+    const char *last = first + file->size();
+
+    // memchr is vectorized by the c library
+    while (first != last) {
+      const char *end = static_cast<const char *>(std::memchr(first, '\n', last - first));
+
+      if (end == nullptr) {
+        end = last;
+      }
+
+      result.emplace_back(first, end - first);
+
+      first = end == last ? last : end + 1;
+    }
+
+    return Iterator<Lines>(std::move(result));
+  }
+
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "jparallel.h"
+#include "jsort.h"
+
+namespace jmixin {
+
+  template<typename Container>
+    class Iterator;
+
+  // A tournament tree of losers over k sorted runs: every inner node keeps
+  // the run that lost the match played there, so replacing the winner only
+  // replays its path to the root, log2(k) comparisons against a single
+  // opponent each. Equal items are taken from the first run first.
+  template<typename InputIterator, typename Compare = std::less<>>
+    class LoserTree {
+
+      public:
+        using Run = std::pair<InputIterator, InputIterator>;
+
+        explicit LoserTree(std::vector<Run> runs, Compare compare = Compare()):
+          _runs(std::move(runs)), _compare(std::move(compare)), _leaves(std::bit_ceil(std::max<std::size_t>(1, _runs.size()))), _tree(_leaves)
+        {
+          std::vector<std::size_t> winners(2*_leaves);
+
+          for (std::size_t i=0; i<_leaves; i++) {
+            winners[_leaves + i] = i;
+          }
+
+          for (std::size_t node=_leaves - 1; node>0; node--) {
+            std::size_t a = winners[2*node];
+            std::size_t b = winners[2*node + 1];
+
+            if (wins(a, b) == true) {
+              winners[node] = a;
+              _tree[node] = b;
+            } else {
+              winners[node] = b;
+              _tree[node] = a;
+            }
+          }
+
+          _tree[0] = winners[1];
+        }
+
+        bool empty() const
+        {
+          return exhausted(_tree[0]);
+        }
+
+        decltype(auto) top() const
+        {
+          return *_runs[_tree[0]].first;
+        }
+
+        // Index of the run holding top().
+        std::size_t run() const
+        {
+          return _tree[0];
+        }
+
+        void pop()
+        {
+          std::size_t winner = _tree[0];
+
+          ++_runs[winner].first;
+
+          for (std::size_t node=(winner + _leaves)/2; node>0; node/=2) {
+            if (wins(_tree[node], winner) == true) {
+              std::swap(_tree[node], winner);
+            }
+          }
+
+          _tree[0] = winner;
+        }
+
+      private:
+        std::vector<Run> _runs;
+        Compare _compare;
+        std::size_t _leaves;
+        std::vector<std::size_t> _tree;
+
+        bool exhausted(std::size_t run) const
+        {
+          return run >= _runs.size() or _runs[run].first == _runs[run].second;
+        }
+
+        bool wins(std::size_t a, std::size_t b) const
+        {
+          if (exhausted(a) == true) {
+            return false;
+          }
+
+          if (exhausted(b) == true) {
+            return true;
+          }
+
+          if (_compare(*_runs[a].first, *_runs[b].first) == true) {
+            return true;
+          }
+
+          // a tie goes to the first run
+          return a < b and _compare(*_runs[b].first, *_runs[a].first) == false;
+        }
+
+    };
+
+  // Stable k-way merge of sorted runs into output.
+  template<typename InputIterator, typename OutputIterator, typename Compare>
+    OutputIterator merge_runs(std::vector<std::pair<InputIterator, InputIterator>> runs, OutputIterator output, Compare compare)
+    {
+      if (runs.size() == 1) {
+        return std::copy(runs[0].first, runs[0].second, output);
+      }
+
+      if (runs.size() == 2) {
+        return std::merge(runs[0].first, runs[0].second, runs[1].first, runs[1].second, output, compare);
+      }
+
+      LoserTree<InputIterator, Compare> tree(std::move(runs), compare);
+
+      for (; tree.empty() == false; tree.pop()) {
+        *output++ = tree.top();
+      }
+
+      return output;
+    }
+
+  // All the items of the containers, which must be sorted, in order.
+  template<typename Container, typename ...Containers>
+    requires (std::is_same_v<Container, Containers> and ...)
+    Iterator<Container> merge_all(const Container &container, const Containers &...containers)
+    {
+      std::vector<std::pair<typename Container::const_iterator, typename Container::const_iterator>> runs {
+        {std::begin(container), std::end(container)}, {std::begin(containers), std::end(containers)}...
+      };
+
+      Container result = make_like<Container>(container);
+
+      if constexpr (requires { result.reserve(std::size_t{}); }) {
+        result.reserve((std::size(container) + ... + std::size(containers)));
+      }
+
+      merge_runs(std::move(runs), std::inserter(result, std::end(result)), std::less<>());
+
+      return Iterator<Container>(std::move(result));
+    }
+
+  namespace parallel {
+
+    // Splitter keys taken from a regular sample of the runs cut every run in
+    // the same places with lower_bound, so the parts hold whole keys and are
+    // merged at the same time, each into its own slice of output.
+    template<typename ExecutionPolicy, typename RandomIt, typename OutputIterator, typename Compare>
+      OutputIterator merge_runs(ExecutionPolicy &&policy, const std::vector<std::pair<RandomIt, RandomIt>> &runs, OutputIterator output, Compare compare)
+      {
+        std::size_t n = 0;
+
+        for (const auto &run : runs) {
+          n = n + std::distance(run.first, run.second);
+        }
+
+        std::size_t parts = chunks(policy, n);
+
+        if constexpr (std::random_access_iterator<RandomIt> and std::random_access_iterator<OutputIterator>) {
+          if (parts > 1 and runs.size() > 1) {
+            std::vector<RandomIt> sample;
+
+            for (const auto &run : runs) {
+              std::size_t size = run.second - run.first;
+              std::size_t count = (size*parts*sort_oversampling + n - 1)/n;
+
+              for (std::size_t i=0; i<count; i++) {
+                sample.push_back(run.first + i*size/count);
+              }
+            }
+
+            std::sort(std::begin(sample), std::end(sample), [&compare](const auto &a, const auto &b) {
+                return compare(*a, *b);
+            });
+
+            std::size_t k = runs.size();
+            std::vector<RandomIt> bounds((parts + 1)*k);
+
+            for (std::size_t run=0; run<k; run++) {
+              bounds[run] = runs[run].first;
+              bounds[parts*k + run] = runs[run].second;
+            }
+
+            for_each_chunk(policy, parts - 1, parts - 1, [&](std::size_t part, std::size_t, std::size_t) {
+                const auto &splitter = *sample[(part + 1)*sample.size()/parts];
+
+                for (std::size_t run=0; run<k; run++) {
+                  bounds[(part + 1)*k + run] = std::lower_bound(runs[run].first, runs[run].second, splitter, compare);
+                }
+            });
+
+            std::vector<std::size_t> offsets(parts + 1);
+
+            for (std::size_t part=1; part<=parts; part++) {
+              for (std::size_t run=0; run<k; run++) {
+                offsets[part] = offsets[part] + (bounds[part*k + run] - runs[run].first);
+              }
+            }
+
+            for_each_chunk(policy, parts, parts, [&](std::size_t part, std::size_t, std::size_t) {
+                std::vector<std::pair<RandomIt, RandomIt>> slices;
+
+                for (std::size_t run=0; run<k; run++) {
+                  if (bounds[part*k + run] != bounds[(part + 1)*k + run]) {
+                    slices.emplace_back(bounds[part*k + run], bounds[(part + 1)*k + run]);
+                  }
+                }
+
+                if (slices.empty() == false) {
+                  jmixin::merge_runs(std::move(slices), output + offsets[part], compare);
+                }
+            });
+
+            return output + n;
+          }
+        }
+
+        return jmixin::merge_runs(runs, output, compare);
+      }
+
+  }
+
+}
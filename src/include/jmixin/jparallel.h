@@ -0,0 +1,815 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "jarena.h"
+#include "jexecutor.h"
+#include "jsimd.h"
+
+#ifdef JMIXIN_JITERATOR_PARALLEL
+#include <execution>
+#endif
+
+namespace jmixin {
+
+  namespace parallel {
+
+    static constexpr std::size_t default_grain = Executor::default_grain;
+
+    // Tells policies apart from callables in overloads with default arguments.
+#ifdef JMIXIN_JITERATOR_PARALLEL
+    template<typename ExecutionPolicy>
+      inline constexpr bool is_policy_v = is_executor_policy_v<ExecutionPolicy> or std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>;
+#else
+    template<typename ExecutionPolicy>
+      inline constexpr bool is_policy_v = is_executor_policy_v<ExecutionPolicy>;
+#endif
+
+    // Number of chunks used to split n items: an executor policy carries its
+    // own grain size, standard policies get a few chunks per hardware thread.
+    template<typename ExecutionPolicy>
+      std::size_t chunks(const ExecutionPolicy &policy, std::size_t n)
+      {
+        std::size_t grain = default_grain;
+
+        if constexpr (is_executor_policy_v<ExecutionPolicy>) {
+          grain = std::max<std::size_t>(1, policy.grain);
+
+          return std::max<std::size_t>(1, (n + grain - 1)/grain);
+        } else {
+          std::size_t workers = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+          return std::clamp<std::size_t>((n + grain - 1)/grain, 1, 4*workers);
+        }
+      }
+
+    // Number of threads that may run chunks at the same time; algorithms that
+    // keep a private table per chunk use it to bound their memory.
+    template<typename ExecutionPolicy>
+      std::size_t concurrency(const ExecutionPolicy &policy)
+      {
+        if constexpr (is_executor_policy_v<ExecutionPolicy>) {
+          return policy.executor->workers() + 1;
+        } else {
+          return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+      }
+
+    // Calls f(chunk, begin, end) for each of the chunks that split the index
+    // range [0, n); chunk boundaries only depend on n and the chunk count.
+    template<typename ExecutionPolicy, typename Function>
+      void for_each_chunk(ExecutionPolicy &&policy, std::size_t n, std::size_t count, Function f)
+      {
+        auto body = [n, count, &f](std::size_t chunk) {
+          f(chunk, chunk*n/count, (chunk + 1)*n/count);
+        };
+
+        if constexpr (is_executor_policy_v<ExecutionPolicy>) {
+          policy.executor->parallel_for(count, 1, [&body](std::size_t begin, std::size_t end) {
+              for (std::size_t chunk=begin; chunk<end; chunk++) {
+                body(chunk);
+              }
+          });
+        } else {
+          std::vector<std::size_t> ids(count);
+
+          std::iota(std::begin(ids), std::end(ids), 0);
+
+          std::for_each(policy, std::begin(ids), std::end(ids), body);
+        }
+      }
+
+    // Smallest index i in [0, n) for which predicate(i) holds, or n. Chunks
+    // starting after an index already found are skipped.
+    template<typename ExecutionPolicy, typename Predicate>
+      std::size_t find_index(ExecutionPolicy &&policy, std::size_t n, Predicate predicate)
+      {
+        std::atomic<std::size_t> result {n};
+
+        for_each_chunk(policy, n, chunks(policy, n), [&](std::size_t, std::size_t begin, std::size_t end) {
+            for (std::size_t i=begin; i<end and i<result.load(std::memory_order_relaxed); i++) {
+              if (predicate(i) == true) {
+                std::size_t current = result.load();
+
+                while (i < current and result.compare_exchange_weak(current, i) == false) {
+                }
+
+                return;
+              }
+            }
+        });
+
+        return result.load();
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename Callback>
+      void for_each(ExecutionPolicy &&policy, InputIterator first, InputIterator last, Callback callback)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          std::for_each(policy, first, last, callback);
+        } else if constexpr (std::random_access_iterator<InputIterator>) {
+          std::size_t n = std::distance(first, last);
+
+          for_each_chunk(policy, n, chunks(policy, n), [&](std::size_t, std::size_t begin, std::size_t end) {
+              std::for_each(first + begin, first + end, callback);
+          });
+        } else {
+          std::for_each(first, last, callback);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename Callback>
+      void for_each_n(ExecutionPolicy &&policy, InputIterator first, std::size_t n, Callback callback)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          std::for_each_n(policy, first, n, callback);
+        } else {
+          parallel::for_each(policy, first, std::next(first, n), callback);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename T>
+      void fill(ExecutionPolicy &&policy, InputIterator first, InputIterator last, const T &value)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          std::fill(policy, first, last, value);
+        } else {
+          parallel::for_each(policy, first, last, [&value](auto &item) {
+              item = value;
+          });
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename T>
+      void fill_n(ExecutionPolicy &&policy, InputIterator first, std::size_t n, const T &value)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          std::fill_n(policy, first, n, value);
+        } else {
+          parallel::fill(policy, first, std::next(first, n), value);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename Predicate>
+      std::size_t count_if(ExecutionPolicy &&policy, InputIterator first, InputIterator last, Predicate predicate)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::count_if(policy, first, last, predicate);
+        } else if constexpr (std::random_access_iterator<InputIterator>) {
+          std::size_t n = std::distance(first, last);
+          std::size_t count = chunks(policy, n);
+          std::vector<std::size_t> partial(count);
+
+          for_each_chunk(policy, n, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+              partial[chunk] = std::count_if(first + begin, first + end, predicate);
+          });
+
+          return std::accumulate(std::begin(partial), std::end(partial), std::size_t{0});
+        } else {
+          return std::count_if(first, last, predicate);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename Predicate>
+      InputIterator find_if(ExecutionPolicy &&policy, InputIterator first, InputIterator last, Predicate predicate)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::find_if(policy, first, last, predicate);
+        } else if constexpr (std::random_access_iterator<InputIterator>) {
+          return first + find_index(policy, std::distance(first, last), [&](std::size_t i) {
+              return predicate(first[i]);
+          });
+        } else {
+          return std::find_if(first, last, predicate);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename Predicate>
+      bool all_of(ExecutionPolicy &&policy, InputIterator first, InputIterator last, Predicate predicate)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::all_of(policy, first, last, predicate);
+        } else {
+          return parallel::find_if(policy, first, last, [&predicate](const auto &item) {
+              return !predicate(item);
+          }) == last;
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename Predicate>
+      bool any_of(ExecutionPolicy &&policy, InputIterator first, InputIterator last, Predicate predicate)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::any_of(policy, first, last, predicate);
+        } else {
+          return parallel::find_if(policy, first, last, predicate) != last;
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename Predicate>
+      bool none_of(ExecutionPolicy &&policy, InputIterator first, InputIterator last, Predicate predicate)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::none_of(policy, first, last, predicate);
+        } else {
+          return parallel::find_if(policy, first, last, predicate) == last;
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator1, typename InputIterator2>
+      bool equal(ExecutionPolicy &&policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::equal(policy, first1, last1, first2);
+        } else if constexpr (std::random_access_iterator<InputIterator1> and std::random_access_iterator<InputIterator2>) {
+          std::size_t n = std::distance(first1, last1);
+
+          return find_index(policy, n, [&](std::size_t i) {
+              return !(first1[i] == first2[i]);
+          }) == n;
+        } else {
+          return std::equal(first1, last1, first2);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator1, typename InputIterator2>
+      bool lexicographical_compare(ExecutionPolicy &&policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::lexicographical_compare(policy, first1, last1, first2, last2);
+        } else if constexpr (std::random_access_iterator<InputIterator1> and std::random_access_iterator<InputIterator2>) {
+          std::size_t n1 = std::distance(first1, last1);
+          std::size_t n2 = std::distance(first2, last2);
+          std::size_t n = std::min(n1, n2);
+
+          std::size_t i = find_index(policy, n, [&](std::size_t i) {
+              return first1[i] < first2[i] or first2[i] < first1[i];
+          });
+
+          if (i < n) {
+            return first1[i] < first2[i];
+          }
+
+          return n1 < n2;
+        } else {
+          return std::lexicographical_compare(first1, last1, first2, last2);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator>
+      void reverse(ExecutionPolicy &&policy, InputIterator first, InputIterator last)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          std::reverse(policy, first, last);
+        } else if constexpr (std::random_access_iterator<InputIterator>) {
+          std::size_t n = std::distance(first, last);
+          std::size_t half = n/2;
+
+          for_each_chunk(policy, half, chunks(policy, half), [&](std::size_t, std::size_t begin, std::size_t end) {
+              for (std::size_t i=begin; i<end; i++) {
+                std::iter_swap(first + i, first + (n - 1 - i));
+              }
+          });
+        } else {
+          std::reverse(first, last);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator>
+      void rotate(ExecutionPolicy &&policy, InputIterator first, InputIterator middle, InputIterator last)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          std::rotate(policy, first, middle, last);
+        } else if constexpr (std::random_access_iterator<InputIterator>) {
+          parallel::reverse(policy, first, middle);
+          parallel::reverse(policy, middle, last);
+          parallel::reverse(policy, first, last);
+        } else {
+          std::rotate(first, middle, last);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename T, typename Operation>
+      T reduce(ExecutionPolicy &&policy, InputIterator first, InputIterator last, T initial, Operation operation)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::reduce(policy, first, last, initial, operation);
+        } else if constexpr (std::random_access_iterator<InputIterator>) {
+          std::size_t n = std::distance(first, last);
+          std::size_t count = chunks(policy, n);
+          std::vector<std::optional<T>> partial(count);
+
+          for_each_chunk(policy, n, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+              if (begin == end) {
+                return;
+              }
+
+              if constexpr (simd::is_reducible_v<InputIterator, T, Operation>) {
+                partial[chunk] = simd::reduce(std::to_address(first) + begin + 1, end - begin - 1, T(first[begin]), operation);
+              } else {
+                T value = first[begin];
+
+                for (std::size_t i=begin + 1; i<end; i++) {
+                  value = operation(value, first[i]);
+                }
+
+                partial[chunk] = std::move(value);
+              }
+          });
+
+          for (auto &value : partial) {
+            if (value) {
+              initial = operation(initial, *value);
+            }
+          }
+
+          return initial;
+        } else {
+          return std::reduce(first, last, initial, operation);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename BinaryPredicate = std::equal_to<>>
+      InputIterator unique(ExecutionPolicy &&policy, InputIterator first, InputIterator last, BinaryPredicate predicate = BinaryPredicate())
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::unique(policy, first, last, predicate);
+        } else {
+          return std::unique(first, last, predicate);
+        }
+      }
+
+    // Block partition in place: every chunk is partitioned on its own, then
+    // the items left on the wrong side of the final split point, the false
+    // ones before it and the true ones after it, are equally many and are
+    // swapped pairwise, also split among the chunks. Not stable.
+    template<typename ExecutionPolicy, typename RandomIt, typename Predicate>
+      RandomIt block_partition(ExecutionPolicy &&policy, RandomIt first, RandomIt last, Predicate predicate)
+      {
+        std::size_t n = last - first;
+        std::size_t count = chunks(policy, n);
+
+        if (count < 2) {
+          return std::partition(first, last, predicate);
+        }
+
+        std::vector<std::size_t> middles(count);
+
+        for_each_chunk(policy, n, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            middles[chunk] = std::partition(first + begin, first + end, predicate) - first;
+        });
+
+        std::size_t split = 0;
+
+        for (std::size_t chunk=0; chunk<count; chunk++) {
+          split = split + (middles[chunk] - chunk*n/count);
+        }
+
+        // [begin, end) runs of the misplaced items, in order, and the number of
+        // items before each run
+        std::vector<std::pair<std::size_t, std::size_t>> falses;
+        std::vector<std::pair<std::size_t, std::size_t>> trues;
+        std::vector<std::size_t> false_offsets {0};
+        std::vector<std::size_t> true_offsets {0};
+
+        for (std::size_t chunk=0; chunk<count; chunk++) {
+          std::size_t begin = chunk*n/count;
+          std::size_t end = (chunk + 1)*n/count;
+
+          if (middles[chunk] < std::min(end, split)) {
+            falses.emplace_back(middles[chunk], std::min(end, split));
+            false_offsets.push_back(false_offsets.back() + (falses.back().second - falses.back().first));
+          }
+
+          if (std::max(begin, split) < middles[chunk]) {
+            trues.emplace_back(std::max(begin, split), middles[chunk]);
+            true_offsets.push_back(true_offsets.back() + (trues.back().second - trues.back().first));
+          }
+        }
+
+        std::size_t misplaced = false_offsets.back();
+
+        if (misplaced == 0) {
+          return first + split;
+        }
+
+        for_each_chunk(policy, misplaced, chunks(policy, misplaced), [&](std::size_t, std::size_t begin, std::size_t end) {
+            if (begin == end) {
+              return;
+            }
+
+            std::size_t i = std::upper_bound(std::begin(false_offsets), std::end(false_offsets), begin) - std::begin(false_offsets) - 1;
+            std::size_t j = std::upper_bound(std::begin(true_offsets), std::end(true_offsets), begin) - std::begin(true_offsets) - 1;
+            std::size_t a = falses[i].first + (begin - false_offsets[i]);
+            std::size_t b = trues[j].first + (begin - true_offsets[j]);
+
+            for (std::size_t k=begin; k<end; k++) {
+              if (a == falses[i].second) {
+                a = falses[++i].first;
+              }
+
+              if (b == trues[j].second) {
+                b = trues[++j].first;
+              }
+
+              std::iter_swap(first + a++, first + b++);
+            }
+        });
+
+        return first + split;
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename Predicate>
+      InputIterator partition(ExecutionPolicy &&policy, InputIterator first, InputIterator last, Predicate predicate)
+      {
+        if constexpr (std::random_access_iterator<InputIterator>) {
+          return block_partition(policy, first, last, predicate);
+        } else if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::partition(policy, first, last, predicate);
+        } else {
+          return std::partition(first, last, predicate);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename Predicate>
+      InputIterator stable_partition(ExecutionPolicy &&policy, InputIterator first, InputIterator last, Predicate predicate)
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::stable_partition(policy, first, last, predicate);
+        } else {
+          return std::stable_partition(first, last, predicate);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator1, typename InputIterator2, typename Compare = std::less<>>
+      bool includes(ExecutionPolicy &&policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, Compare compare = Compare())
+      {
+        if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::includes(policy, first1, last1, first2, last2, compare);
+        } else {
+          return std::includes(first1, last1, first2, last2, compare);
+        }
+      }
+
+    // Random access inputs and output, which merge paths split in slices.
+    template<typename InputIterator1, typename InputIterator2, typename OutputIterator>
+      inline constexpr bool is_merge_path_v = std::random_access_iterator<InputIterator1> and std::random_access_iterator<InputIterator2> and std::random_access_iterator<OutputIterator>;
+
+    // The merge path (Odeh, Green, Mwassi, Shmueli and Birk): how many of the
+    // first diagonal items of the merge of both ranges come from the first
+    // one, by a binary search along the diagonal. Equal items are taken from
+    // the first range first, as std::merge does.
+    template<typename RandomIt1, typename RandomIt2, typename Compare>
+      std::size_t merge_path(RandomIt1 first1, std::size_t n1, RandomIt2 first2, std::size_t n2, std::size_t diagonal, Compare compare)
+      {
+        std::size_t low = diagonal > n2 ? diagonal - n2 : 0;
+        std::size_t high = std::min(diagonal, n1);
+
+        while (low < high) {
+          std::size_t middle = low + (high - low)/2;
+
+          if (compare(first2[diagonal - middle - 1], first1[middle]) == false) {
+            low = middle + 1;
+          } else {
+            high = middle;
+          }
+        }
+
+        return low;
+      }
+
+    // Splits both ranges in count slices along evenly spaced diagonals of the
+    // merge path. With whole_keys a split is moved back to the first item of
+    // its key in both ranges, since the set operations pair equal items and
+    // a run of them must not straddle two slices.
+    template<typename ExecutionPolicy, typename RandomIt1, typename RandomIt2, typename Compare>
+      void merge_splits(ExecutionPolicy &&policy, RandomIt1 first1, std::size_t n1, RandomIt2 first2, std::size_t n2, std::size_t count, std::vector<std::size_t> &splits1, std::vector<std::size_t> &splits2, Compare compare, bool whole_keys)
+      {
+        splits1.assign(count + 1, n1);
+        splits2.assign(count + 1, n2);
+
+        for_each_chunk(policy, count, count, [&](std::size_t chunk, std::size_t, std::size_t) {
+            std::size_t diagonal = chunk*(n1 + n2)/count;
+            std::size_t i = merge_path(first1, n1, first2, n2, diagonal, compare);
+            std::size_t j = diagonal - i;
+
+            if (whole_keys == true and (i < n1 or j < n2)) {
+              auto split = [&](const auto &key) {
+                i = std::lower_bound(first1, first1 + n1, key, compare) - first1;
+                j = std::lower_bound(first2, first2 + n2, key, compare) - first2;
+              };
+
+              if (j == n2 or (i < n1 and compare(first2[j], first1[i]) == false)) {
+                split(first1[i]);
+              } else {
+                split(first2[j]);
+              }
+            }
+
+            splits1[chunk] = i;
+            splits2[chunk] = j;
+        });
+      }
+
+    // Runs operation, a set algorithm with the signature of std::set_union,
+    // on independent slices of both ranges at the same time. Each slice
+    // writes in its own region of a buffer, sized by bound(n1, n2) for a
+    // slice with n1 and n2 items, and the regions are then packed into
+    // output, also at the same time.
+    template<typename ExecutionPolicy, typename RandomIt1, typename RandomIt2, typename RandomIt3, typename Compare, typename Operation, typename Bound>
+      RandomIt3 merge_slices(ExecutionPolicy &&policy, RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, RandomIt3 output, Compare compare, Operation operation, Bound bound)
+      {
+        using value_type = std::iter_value_t<RandomIt3>;
+
+        std::size_t n1 = last1 - first1;
+        std::size_t n2 = last2 - first2;
+        std::size_t count = chunks(policy, n1 + n2);
+
+        if constexpr (std::is_default_constructible_v<value_type>) {
+          if (count > 1) {
+            std::vector<std::size_t> splits1;
+            std::vector<std::size_t> splits2;
+
+            merge_splits(policy, first1, n1, first2, n2, count, splits1, splits2, compare, true);
+
+            std::vector<std::size_t> offsets(count + 1);
+            std::vector<std::size_t> sizes(count + 1);
+
+            for (std::size_t chunk=0; chunk<count; chunk++) {
+              offsets[chunk + 1] = offsets[chunk] + bound(splits1[chunk + 1] - splits1[chunk], splits2[chunk + 1] - splits2[chunk]);
+            }
+
+            std::vector<value_type> buffer(offsets[count]);
+
+            for_each_chunk(policy, count, count, [&](std::size_t chunk, std::size_t, std::size_t) {
+                auto begin = std::begin(buffer) + offsets[chunk];
+                auto end = operation(first1 + splits1[chunk], first1 + splits1[chunk + 1], first2 + splits2[chunk], first2 + splits2[chunk + 1], begin, compare);
+
+                sizes[chunk] = end - begin;
+            });
+
+            std::exclusive_scan(std::begin(sizes), std::end(sizes), std::begin(sizes), std::size_t{0});
+
+            for_each_chunk(policy, count, count, [&](std::size_t chunk, std::size_t, std::size_t) {
+                auto begin = std::begin(buffer) + offsets[chunk];
+
+                std::move(begin, begin + (sizes[chunk + 1] - sizes[chunk]), output + sizes[chunk]);
+            });
+
+            return output + sizes[count];
+          }
+        }
+
+        return operation(first1, last1, first2, last2, output, compare);
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare = std::less<>>
+      OutputIterator merge(ExecutionPolicy &&policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, OutputIterator output, Compare compare = Compare())
+      {
+        if constexpr (is_merge_path_v<InputIterator1, InputIterator2, OutputIterator>) {
+          // the size of every slice is known, so they merge straight into output
+          std::size_t n1 = last1 - first1;
+          std::size_t n2 = last2 - first2;
+          std::size_t count = chunks(policy, n1 + n2);
+          std::vector<std::size_t> splits1;
+          std::vector<std::size_t> splits2;
+
+          merge_splits(policy, first1, n1, first2, n2, count, splits1, splits2, compare, false);
+
+          for_each_chunk(policy, count, count, [&](std::size_t chunk, std::size_t, std::size_t) {
+              std::merge(first1 + splits1[chunk], first1 + splits1[chunk + 1], first2 + splits2[chunk], first2 + splits2[chunk + 1], output + (splits1[chunk] + splits2[chunk]), compare);
+          });
+
+          return output + (n1 + n2);
+        } else if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::merge(policy, first1, last1, first2, last2, output, compare);
+        } else {
+          return std::merge(first1, last1, first2, last2, output, compare);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare = std::less<>>
+      OutputIterator set_difference(ExecutionPolicy &&policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, OutputIterator output, Compare compare = Compare())
+      {
+        if constexpr (is_merge_path_v<InputIterator1, InputIterator2, OutputIterator>) {
+          return merge_slices(policy, first1, last1, first2, last2, output, compare, [](auto... args) {
+              return std::set_difference(args...);
+          }, [](std::size_t n1, std::size_t) {
+              return n1;
+          });
+        } else if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::set_difference(policy, first1, last1, first2, last2, output, compare);
+        } else {
+          return std::set_difference(first1, last1, first2, last2, output, compare);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare = std::less<>>
+      OutputIterator set_intersection(ExecutionPolicy &&policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, OutputIterator output, Compare compare = Compare())
+      {
+        if constexpr (is_merge_path_v<InputIterator1, InputIterator2, OutputIterator>) {
+          return merge_slices(policy, first1, last1, first2, last2, output, compare, [](auto... args) {
+              return std::set_intersection(args...);
+          }, [](std::size_t n1, std::size_t n2) {
+              return std::min(n1, n2);
+          });
+        } else if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::set_intersection(policy, first1, last1, first2, last2, output, compare);
+        } else {
+          return std::set_intersection(first1, last1, first2, last2, output, compare);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator1, typename InputIterator2, typename OutputIterator, typename Compare = std::less<>>
+      OutputIterator set_union(ExecutionPolicy &&policy, InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2, OutputIterator output, Compare compare = Compare())
+      {
+        if constexpr (is_merge_path_v<InputIterator1, InputIterator2, OutputIterator>) {
+          return merge_slices(policy, first1, last1, first2, last2, output, compare, [](auto... args) {
+              return std::set_union(args...);
+          }, [](std::size_t n1, std::size_t n2) {
+              return n1 + n2;
+          });
+        } else if constexpr (not is_executor_policy_v<ExecutionPolicy>) {
+          return std::set_union(policy, first1, last1, first2, last2, output, compare);
+        } else {
+          return std::set_union(first1, last1, first2, last2, output, compare);
+        }
+      }
+
+    // Keeps in heap the k greatest items (by compare) seen so far, with the
+    // smallest of them on the front, so each item costs O(log k).
+    template<typename InputIterator, typename T, typename Compare>
+      void keep_top(InputIterator first, InputIterator last, std::size_t k, std::vector<T> &heap, Compare compare)
+      {
+        auto greater = [&compare](const auto &a, const auto &b) {
+          return compare(b, a);
+        };
+
+        if (k == 0) {
+          return;
+        }
+
+        for (; first!=last; ++first) {
+          if (heap.size() < k) {
+            heap.push_back(*first);
+
+            std::push_heap(std::begin(heap), std::end(heap), greater);
+          } else if (compare(heap.front(), *first) == true) {
+            std::pop_heap(std::begin(heap), std::end(heap), greater);
+
+            heap.back() = *first;
+
+            std::push_heap(std::begin(heap), std::end(heap), greater);
+          }
+        }
+      }
+
+    // The k greatest items, greatest first. Every chunk fills its own heap
+    // and the heaps are merged at the end.
+    template<typename ExecutionPolicy, typename InputIterator, typename Compare>
+      std::vector<std::iter_value_t<InputIterator>> top_k(ExecutionPolicy &&policy, InputIterator first, InputIterator last, std::size_t k, Compare compare)
+      {
+        std::vector<std::iter_value_t<InputIterator>> result;
+
+        if constexpr (std::random_access_iterator<InputIterator>) {
+          std::size_t n = std::distance(first, last);
+          std::size_t count = chunks(policy, n);
+          std::vector<std::vector<std::iter_value_t<InputIterator>>> heaps(count);
+
+          for_each_chunk(policy, n, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+              keep_top(first + begin, first + end, k, heaps[chunk], compare);
+          });
+
+          for (auto &heap : heaps) {
+            keep_top(std::make_move_iterator(std::begin(heap)), std::make_move_iterator(std::end(heap)), k, result, compare);
+          }
+        } else {
+          keep_top(first, last, k, result, compare);
+        }
+
+        std::sort_heap(std::begin(result), std::end(result), [&compare](const auto &a, const auto &b) {
+            return compare(b, a);
+        });
+
+        return result;
+      }
+
+    // Sequence containers that can be presized and written through real
+    // references, so every worker owns a disjoint set of indexes.
+    template<typename Container>
+      inline constexpr bool is_indexable_v = requires (Container &container, std::size_t n) {
+        requires std::random_access_iterator<decltype(std::begin(container))>;
+        requires std::is_same_v<decltype(*std::begin(container)), typename Container::value_type &>;
+        requires std::is_default_constructible_v<typename Container::value_type>;
+        container.resize(n);
+      };
+
+    // Appends operation(item) for every item in [first, last) to output. An
+    // insert iterator can not be shared by several threads, so indexable
+    // outputs are resized up front and each chunk writes its own slots;
+    // node based containers fall back to a sequential insertion.
+    template<typename ExecutionPolicy, typename InputIterator, typename Container, typename Operation>
+      void transform(ExecutionPolicy &&policy, InputIterator first, InputIterator last, Container &output, Operation operation)
+      {
+        if constexpr (std::random_access_iterator<InputIterator> and is_indexable_v<Container>) {
+          std::size_t n = std::distance(first, last);
+          std::size_t offset = std::size(output);
+
+          output.resize(offset + n);
+
+          auto result = std::next(std::begin(output), offset);
+
+          for_each_chunk(policy, n, chunks(policy, n), [&](std::size_t, std::size_t begin, std::size_t end) {
+              for (std::size_t i=begin; i<end; i++) {
+                result[i] = operation(first[i]);
+              }
+          });
+        } else {
+          (void)policy;
+
+          std::transform(first, last, std::inserter(output, std::end(output)), operation);
+        }
+      }
+
+    template<typename ExecutionPolicy, typename InputIterator, typename Container>
+      void copy(ExecutionPolicy &&policy, InputIterator first, InputIterator last, Container &output)
+      {
+        parallel::transform(policy, first, last, output, [](const auto &item) -> const auto & {
+            return item;
+        });
+      }
+
+    // Stream compaction in three phases: each chunk flags and counts the
+    // items the predicate keeps, an exclusive scan turns the counts into
+    // output offsets and each chunk then moves its flagged items to their
+    // final position, so the predicate runs once per item. It receives the
+    // item and its index, so it never needs shared state. Containers without
+    // random access fall back to a sequential pass.
+    template<typename ExecutionPolicy, typename Container, typename Predicate>
+      void compact(ExecutionPolicy &&policy, Container &container, Predicate predicate)
+      {
+        using iterator = decltype(std::begin(container));
+        using value_type = typename Container::value_type;
+
+        if constexpr (std::random_access_iterator<iterator> and std::is_default_constructible_v<value_type>) {
+          std::size_t n = std::size(container);
+          std::size_t count = chunks(policy, n);
+          std::vector<std::size_t> offsets(count + 1);
+          std::vector<char> keep(n);
+
+          auto first = std::begin(container);
+
+          for_each_chunk(policy, n, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+              std::size_t kept = 0;
+
+              for (std::size_t i=begin; i<end; i++) {
+                keep[i] = predicate(std::as_const(first[i]), i) == true;
+                kept = kept + keep[i];
+              }
+
+              offsets[chunk + 1] = kept;
+          });
+
+          std::inclusive_scan(std::begin(offsets), std::end(offsets), std::begin(offsets));
+
+          if (offsets[count] == n) {
+            return;
+          }
+
+          Container result = make_like<Container>(container, offsets[count]);
+
+          auto output = std::begin(result);
+
+          for_each_chunk(policy, n, count, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+              std::size_t offset = offsets[chunk];
+
+              for (std::size_t i=begin; i<end; i++) {
+                if (keep[i] != 0) {
+                  output[offset++] = std::move(first[i]);
+                }
+              }
+          });
+
+          container = std::move(result);
+        } else {
+          std::size_t i = 0;
+
+          (void)policy;
+
+          container.erase(std::remove_if(std::begin(container), std::end(container), [&](const auto &item) {
+                return !predicate(item, i++);
+          }), std::end(container));
+        }
+      }
+
+  }
+
+}
@@ -0,0 +1,565 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "jiterator.h"
+
+namespace jmixin {
+
+  // Bounded lock free multi-producer multi-consumer ring buffer (Dmitry
+  // Vyukov's algorithm): every cell has a sequence number that tells whether
+  // it is ready to be written or read in the current lap, so producers and
+  // consumers only contend on their own index.
+  template<typename T>
+    class BoundedQueue {
+
+      public:
+        explicit BoundedQueue(std::size_t capacity):
+          _mask(std::bit_ceil(std::max<std::size_t>(2, capacity)) - 1), _cells(new Cell[_mask + 1])
+        {
+          for (std::size_t i=0; i<=_mask; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+          }
+        }
+
+        BoundedQueue(const BoundedQueue &) = delete;
+
+        BoundedQueue & operator=(const BoundedQueue &) = delete;
+
+        std::size_t capacity() const
+        {
+          return _mask + 1;
+        }
+
+        // Moves value in unless the queue is full.
+        bool try_push(T &value)
+        {
+          std::size_t position = _enqueue.load(std::memory_order_relaxed);
+          Cell *cell;
+
+          while (true) {
+            cell = &_cells[position & _mask];
+
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+            if (difference == 0) {
+              if (_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed) == true) {
+                break;
+              }
+            } else if (difference < 0) {
+              return false;
+            } else {
+              position = _enqueue.load(std::memory_order_relaxed);
+            }
+          }
+
+          cell->value.emplace(std::move(value));
+          cell->sequence.store(position + 1, std::memory_order_release);
+
+          return true;
+        }
+
+        bool try_pop(T &value)
+        {
+          std::size_t position = _dequeue.load(std::memory_order_relaxed);
+          Cell *cell;
+
+          while (true) {
+            cell = &_cells[position & _mask];
+
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+
+            if (difference == 0) {
+              if (_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed) == true) {
+                break;
+              }
+            } else if (difference < 0) {
+              return false;
+            } else {
+              position = _dequeue.load(std::memory_order_relaxed);
+            }
+          }
+
+          value = std::move(*cell->value);
+
+          cell->value.reset();
+          cell->sequence.store(position + _mask + 1, std::memory_order_release);
+
+          return true;
+        }
+
+      private:
+        struct Cell {
+          std::atomic<std::size_t> sequence;
+          std::optional<T> value;
+        };
+
+        std::size_t _mask;
+        std::unique_ptr<Cell[]> _cells;
+        alignas(64) std::atomic<std::size_t> _enqueue {0};
+        alignas(64) std::atomic<std::size_t> _dequeue {0};
+
+    };
+
+  struct StageStats {
+    std::string name;
+    std::size_t threads {0};
+    std::size_t items {0};
+    std::size_t stalls {0};
+    std::chrono::nanoseconds busy {0};
+    std::chrono::nanoseconds elapsed {0};
+
+    // items produced per second of the stage lifetime
+    double throughput() const
+    {
+      return elapsed.count() == 0 ? 0.0 : items*1e9/elapsed.count();
+    }
+  };
+
+  namespace detail {
+
+    // State shared by all the stages of a run: the first error cancels it
+    // and wakes the threads blocked on any of its channels.
+    struct PipelineState {
+      std::atomic<bool> cancelled {false};
+      std::mutex mutex;
+      std::exception_ptr error;
+      std::vector<std::atomic<std::uint32_t> *> events;
+
+      void fail(std::exception_ptr exception)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!error) {
+          error = exception;
+        }
+
+        cancelled.store(true, std::memory_order_release);
+
+        for (auto *event : events) {
+          event->fetch_add(1, std::memory_order_release);
+          event->notify_all();
+        }
+      }
+    };
+
+    // A queue closed when its last producer is done. A full queue blocks the
+    // producers (the backpressure), an empty one the consumers: they spin
+    // for a while, since the other side usually answers quickly, then yield
+    // and finally sleep on the event counter of the channel, which every
+    // push, pop, done and cancel bumps while someone sleeps.
+    template<typename T>
+      class Channel {
+
+        public:
+          Channel(std::size_t capacity, std::size_t producers, std::shared_ptr<PipelineState> state):
+            _queue(capacity), _producers(producers), _state(std::move(state))
+          {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+
+            _state->events.push_back(&_events);
+          }
+
+          Channel(const Channel &) = delete;
+
+          Channel & operator=(const Channel &) = delete;
+
+          ~Channel()
+          {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+
+            std::erase(_state->events, &_events);
+          }
+
+          // Returns false if the pipeline was cancelled.
+          bool push(T &value, std::size_t &stalls)
+          {
+            Waiter waiter(*this);
+
+            while (_queue.try_push(value) == false) {
+              if (cancelled() == true) {
+                return false;
+              }
+
+              if (waiter.idle() == true) {
+                stalls++;
+              }
+
+              waiter.wait();
+            }
+
+            notify();
+
+            return true;
+          }
+
+          // Returns false once the queue is closed and empty.
+          bool pop(T &value)
+          {
+            Waiter waiter(*this);
+
+            while (_queue.try_pop(value) == false) {
+              if (cancelled() == true) {
+                return false;
+              }
+
+              if (_producers.load(std::memory_order_acquire) == 0) {
+                if (_queue.try_pop(value) == false) {
+                  return false;
+                }
+
+                break;
+              }
+
+              waiter.wait();
+            }
+
+            notify();
+
+            return true;
+          }
+
+          void done()
+          {
+            _producers.fetch_sub(1, std::memory_order_acq_rel);
+
+            notify();
+          }
+
+        private:
+          // Before sleeping a thread counts itself as a waiter and retries
+          // once more: the fences order that count against the queue, so an
+          // operation that did not see the waiter is seen by the retry.
+          class Waiter {
+
+            public:
+              explicit Waiter(Channel &channel):
+                _channel(channel)
+              {
+              }
+
+              ~Waiter()
+              {
+                if (_parked == true) {
+                  _channel._waiters.fetch_sub(1, std::memory_order_relaxed);
+                }
+              }
+
+              bool idle() const
+              {
+                return _spins == 0;
+              }
+
+              void wait()
+              {
+                if (_parked == true) {
+                  _channel._events.wait(_event, std::memory_order_acquire);
+                  _event = _channel._events.load(std::memory_order_acquire);
+
+                  return;
+                }
+
+                if (++_spins < 64) {
+                  return;
+                }
+
+                if (_spins < 128) {
+                  std::this_thread::yield();
+
+                  return;
+                }
+
+                _channel._waiters.fetch_add(1, std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                _event = _channel._events.load(std::memory_order_acquire);
+                _parked = true;
+              }
+
+            private:
+              Channel &_channel;
+              std::size_t _spins {0};
+              std::uint32_t _event {0};
+              bool _parked {false};
+
+          };
+
+          BoundedQueue<T> _queue;
+          std::atomic<std::size_t> _producers;
+          std::shared_ptr<PipelineState> _state;
+          alignas(64) std::atomic<std::uint32_t> _events {0};
+          std::atomic<std::size_t> _waiters {0};
+
+          bool cancelled() const
+          {
+            return _state->cancelled.load(std::memory_order_acquire);
+          }
+
+          void notify()
+          {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (_waiters.load(std::memory_order_relaxed) != 0) {
+              _events.fetch_add(1, std::memory_order_release);
+              _events.notify_all();
+            }
+          }
+
+      };
+
+    struct Stage {
+      std::size_t threads;
+      std::function<void(StageStats &)> body;
+      std::shared_ptr<StageStats> stats;
+    };
+
+  }
+
+  // Runs every stage on its own threads, linked by bounded queues, so the
+  // stages overlap: a stage starts working on the first items while the
+  // previous one is still producing. Stages with more than one thread do
+  // not keep the order of the items, which must be default constructible. Building a pipeline runs nothing; the
+  // terminal methods (for_each, collect) run it once and then stats()
+  // reports every stage.
+  template<typename T>
+    class Pipeline {
+
+      template<typename U>
+        friend class Pipeline;
+
+      public:
+        static constexpr std::size_t default_capacity = 1024;
+
+        // source(sink) calls sink(item) for every item, stopping early when
+        // sink returns false.
+        template<typename Source>
+          explicit Pipeline(Source source, std::size_t capacity = default_capacity):
+            _state(std::make_shared<detail::PipelineState>())
+          {
+            _output = std::make_shared<detail::Channel<T>>(capacity, 1, _state);
+
+            add("source", 1, [source=std::move(source), output=_output](StageStats &stats) mutable {
+                source([&](auto &&item) {
+                    T value(std::forward<decltype(item)>(item));
+
+                    stats.items++;
+
+                    return output->push(value, stats.stalls);
+                });
+            }, _output);
+          }
+
+        template<typename Function>
+          auto map(const std::string &name, Function function, std::size_t threads = 1, std::size_t capacity = default_capacity) &&
+          {
+            using Result = std::decay_t<std::invoke_result_t<Function &, T &&>>;
+
+            return std::move(*this).template chain<Result>(name, threads, capacity, [function](T &&item, auto &emit) mutable {
+                return emit(function(std::move(item)));
+            });
+          }
+
+        template<typename Predicate>
+          auto filter(const std::string &name, Predicate predicate, std::size_t threads = 1, std::size_t capacity = default_capacity) &&
+          {
+            return std::move(*this).template chain<T>(name, threads, capacity, [predicate](T &&item, auto &emit) mutable {
+                if (predicate(std::as_const(item)) == false) {
+                  return true;
+                }
+
+                return emit(std::move(item));
+            });
+          }
+
+        // Consumes the items on the calling thread; rethrows the first
+        // exception of any stage.
+        template<typename Callback>
+          void for_each(Callback callback)
+          {
+            run([&callback](T &&item) {
+                callback(std::move(item));
+            });
+          }
+
+        template<typename Container = std::vector<T>>
+          Iterator<Container> collect()
+          {
+            Iterator<Container> result;
+
+            run([&result](T &&item) {
+                result.insert(std::end(result), std::move(item));
+            });
+
+            return result;
+          }
+
+        std::vector<StageStats> stats() const
+        {
+          std::vector<StageStats> result;
+
+          for (const auto &stage : _stages) {
+            result.push_back(*stage.stats);
+          }
+
+          return result;
+        }
+
+      private:
+        std::shared_ptr<detail::PipelineState> _state;
+        std::shared_ptr<detail::Channel<T>> _output;
+        std::vector<detail::Stage> _stages;
+        bool _done {false};
+
+        Pipeline() = default;
+
+        // Each thread of a stage closes its share of the output channel.
+        template<typename Body, typename Output>
+          void add(const std::string &name, std::size_t threads, Body body, std::shared_ptr<Output> output)
+          {
+            auto stats = std::make_shared<StageStats>();
+
+            stats->name = name;
+            stats->threads = threads;
+
+            _stages.push_back({threads, [body=std::move(body), output=std::move(output)](StageStats &stats) mutable {
+                body(stats);
+
+                output->done();
+            }, stats});
+          }
+
+        template<typename Result, typename Step>
+          Pipeline<Result> chain(const std::string &name, std::size_t threads, std::size_t capacity, Step step) &&
+          {
+            threads = std::max<std::size_t>(1, threads);
+
+            Pipeline<Result> result;
+
+            result._state = _state;
+            result._stages = std::move(_stages);
+            result._output = std::make_shared<detail::Channel<Result>>(capacity, threads, _state);
+
+            result.add(name, threads, [step, input=_output, output=result._output](StageStats &stats) mutable {
+                // every thread works on its own copy of the function
+                auto function = step;
+                auto emit = [&](Result &&value) {
+                  stats.items++;
+
+                  return output->push(value, stats.stalls);
+                };
+
+                T item;
+
+                while (input->pop(item) == true) {
+                  auto start = std::chrono::steady_clock::now();
+                  bool next = function(std::move(item), emit);
+
+                  stats.busy += std::chrono::steady_clock::now() - start;
+
+                  if (next == false) {
+                    break;
+                  }
+                }
+            }, result._output);
+
+            return result;
+          }
+
+        template<typename Consumer>
+          void run(Consumer consumer)
+          {
+            if (_done == true) {
+              throw std::runtime_error("Pipeline can be run only once");
+            }
+
+            _done = true;
+
+            std::vector<std::thread> threads;
+            std::vector<std::vector<StageStats>> partial;
+
+            for (auto &stage : _stages) {
+              partial.emplace_back(stage.threads);
+            }
+
+            for (std::size_t i=0; i<_stages.size(); i++) {
+              for (std::size_t j=0; j<_stages[i].threads; j++) {
+                threads.emplace_back([this, i, j, &partial]() {
+                    auto start = std::chrono::steady_clock::now();
+
+                    try {
+                      _stages[i].body(partial[i][j]);
+                    } catch (...) {
+                      _state->fail(std::current_exception());
+                    }
+
+                    partial[i][j].elapsed = std::chrono::steady_clock::now() - start;
+                });
+              }
+            }
+
+            T item;
+
+            try {
+              while (_output->pop(item) == true) {
+                consumer(std::move(item));
+              }
+            } catch (...) {
+              _state->fail(std::current_exception());
+            }
+
+            for (auto &thread : threads) {
+              thread.join();
+            }
+
+            for (std::size_t i=0; i<_stages.size(); i++) {
+              StageStats &stats = *_stages[i].stats;
+
+              for (const auto &item : partial[i]) {
+                stats.items += item.items;
+                stats.stalls += item.stalls;
+                stats.busy += item.busy;
+                stats.elapsed = std::max(stats.elapsed, item.elapsed);
+              }
+            }
+
+            if (_state->error) {
+              std::rethrow_exception(_state->error);
+            }
+          }
+
+    };
+
+  // A pipeline over the items of range (copied in the source).
+  template<std::ranges::input_range Range>
+    Pipeline<std::ranges::range_value_t<Range>> pipeline(Range range, std::size_t capacity = Pipeline<std::ranges::range_value_t<Range>>::default_capacity)
+    {
+      return Pipeline<std::ranges::range_value_t<Range>>([range=std::move(range)](auto &&sink) mutable {
+          for (auto &&item : range) {
+            if (sink(item) == false) {
+              return;
+            }
+          }
+      }, capacity);
+    }
+
+}
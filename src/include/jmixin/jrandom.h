@@ -0,0 +1,335 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "jparallel.h"
+
+namespace jmixin {
+
+  // xoshiro256** (Blackman and Vigna): 32 bytes of state and a few shifts
+  // per number, against the 5KB of std::mt19937. A seed is expanded with
+  // splitmix64, so nearby seeds give unrelated sequences.
+  class Xoshiro256 {
+
+    public:
+      using result_type = std::uint64_t;
+
+      explicit Xoshiro256(std::uint64_t value = 0x9e3779b97f4a7c15)
+      {
+        seed(value);
+      }
+
+      static constexpr result_type min()
+      {
+        return 0;
+      }
+
+      static constexpr result_type max()
+      {
+        return std::numeric_limits<result_type>::max();
+      }
+
+      void seed(std::uint64_t value)
+      {
+        for (auto &word : _state) {
+          value = value + 0x9e3779b97f4a7c15;
+
+          std::uint64_t z = value;
+
+          z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9;
+          z = (z ^ (z >> 27))*0x94d049bb133111eb;
+
+          word = z ^ (z >> 31);
+        }
+      }
+
+      result_type operator()()
+      {
+        std::uint64_t result = std::rotl(_state[1]*5, 7)*9;
+        std::uint64_t t = _state[1] << 17;
+
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = std::rotl(_state[3], 45);
+
+        return result;
+      }
+
+      // Advances 2^128 numbers, so copies jumped a different number of times
+      // never overlap.
+      void jump()
+      {
+        static constexpr std::uint64_t polynomial[] = {
+          0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c
+        };
+
+        std::uint64_t state[4] {};
+
+        for (std::uint64_t word : polynomial) {
+          for (int bit=0; bit<64; bit++) {
+            if ((word & (std::uint64_t{1} << bit)) != 0) {
+              for (int i=0; i<4; i++) {
+                state[i] ^= _state[i];
+              }
+            }
+
+            (*this)();
+          }
+        }
+
+        std::copy(std::begin(state), std::end(state), std::begin(_state));
+      }
+
+      bool operator==(const Xoshiro256 &) const = default;
+
+    private:
+      std::uint64_t _state[4];
+
+  };
+
+  // The engine used when none is given: one per thread, seeded once from
+  // std::random_device. Seed it for reproducible runs.
+  inline Xoshiro256 & default_engine()
+  {
+    static thread_local Xoshiro256 engine([]() {
+        std::random_device device;
+
+        return (std::uint64_t{device()} << 32) | device();
+    }());
+
+    return engine;
+  }
+
+  namespace random {
+
+    template<typename URBG>
+      inline constexpr bool is_full_64_v = std::remove_cvref_t<URBG>::min() == 0 and std::remove_cvref_t<URBG>::max() == std::numeric_limits<std::uint64_t>::max();
+
+    template<typename URBG>
+      std::uint64_t bits(URBG &g)
+      {
+        if constexpr (is_full_64_v<URBG>) {
+          return g();
+        } else {
+          return std::uniform_int_distribution<std::uint64_t>()(g);
+        }
+      }
+
+    // Uniform in [0, n) with Lemire's multiply and reject, which divides only
+    // when a number falls in the biased zone; the distribution is the same
+    // on every standard library, unlike std::uniform_int_distribution.
+    template<typename URBG>
+      std::uint64_t bounded(URBG &g, std::uint64_t n)
+      {
+#ifdef __SIZEOF_INT128__
+        __extension__ using uint128 = unsigned __int128;
+
+        uint128 product = uint128{bits(g)}*n;
+        std::uint64_t low = static_cast<std::uint64_t>(product);
+
+        if (low < n) {
+          std::uint64_t threshold = -n % n;
+
+          while (low < threshold) {
+            product = uint128{bits(g)}*n;
+            low = static_cast<std::uint64_t>(product);
+          }
+        }
+
+        return static_cast<std::uint64_t>(product >> 64);
+#else
+        return std::uniform_int_distribution<std::uint64_t>(0, n - 1)(g);
+#endif
+      }
+
+    // Uniform in the open interval (0, 1).
+    template<typename URBG>
+      double unit(URBG &g)
+      {
+        return ((bits(g) >> 11) + 0.5)*0x1.0p-53;
+      }
+
+    // Fisher-Yates.
+    template<typename RandomIt, typename URBG>
+      void shuffle(RandomIt first, RandomIt last, URBG &g)
+      {
+        for (auto n=last - first; n > 1; n--) {
+          std::iter_swap(first + (n - 1), first + bounded(g, n));
+        }
+      }
+
+    // The merge of MergeShuffle (Bacher, Bodini, Hollender and Lumbroso):
+    // joins two shuffled neighbours into a shuffled range in place, taking
+    // the next item of either side by a coin flip and inserting the rest of
+    // the longer side at random positions once the other one is exhausted.
+    template<typename RandomIt>
+      void merge_shuffled(RandomIt first, RandomIt middle, RandomIt last, Xoshiro256 &g)
+      {
+        RandomIt i = first;
+        RandomIt j = middle;
+        std::uint64_t coins = 0;
+        int left = 0;
+
+        while (true) {
+          if (left == 0) {
+            coins = g();
+            left = 64;
+          }
+
+          bool flip = (coins & 1) != 0;
+
+          coins >>= 1;
+          left--;
+
+          if (flip == true) {
+            if (j == last) {
+              break;
+            }
+
+            std::iter_swap(i, j);
+
+            ++j;
+          } else if (i == j) {
+            break;
+          }
+
+          ++i;
+        }
+
+        for (; i != last; ++i) {
+          std::iter_swap(first + bounded(g, (i - first) + 1), i);
+        }
+      }
+
+    // A uniform sample of up to n items of a stream seen once, in any order
+    // (Li's algorithm L): once the reservoir is full it draws how many items
+    // to skip instead of a number per item.
+    template<typename T, typename URBG>
+      class Reservoir {
+
+        public:
+          Reservoir(std::size_t n, URBG &g):
+            _n(n), _g(g)
+          {
+          }
+
+          template<typename Item>
+            void push(Item &&item)
+            {
+              if (_n == 0) {
+                return;
+              }
+
+              if (_items.size() < _n) {
+                _items.emplace_back(std::forward<Item>(item));
+
+                if (_items.size() == _n) {
+                  _w = std::exp(std::log(unit(_g))/_n);
+
+                  skip();
+                }
+
+                return;
+              }
+
+              if (_skip > 0) {
+                _skip--;
+
+                return;
+              }
+
+              _items[bounded(_g, _n)] = std::forward<Item>(item);
+              _w = _w*std::exp(std::log(unit(_g))/_n);
+
+              skip();
+            }
+
+          std::vector<T> items() &&
+          {
+            return std::move(_items);
+          }
+
+        private:
+          std::size_t _n;
+          URBG &_g;
+          std::vector<T> _items;
+          double _w {1.0};
+          std::size_t _skip {0};
+
+          void skip()
+          {
+            double skip = std::floor(std::log(unit(_g))/std::log1p(-_w));
+
+            _skip = skip < static_cast<double>(std::numeric_limits<std::size_t>::max()) ? static_cast<std::size_t>(skip) : std::numeric_limits<std::size_t>::max();
+          }
+
+      };
+
+  }
+
+  namespace parallel {
+
+    static constexpr std::size_t shuffle_grain = 1 << 14;
+
+    // MergeShuffle: the blocks are shuffled at the same time with engines
+    // seeded from g, then merged pairwise, the merges of a level also at the
+    // same time. Only the last merge runs alone.
+    template<typename ExecutionPolicy, typename RandomIt, typename URBG>
+      void shuffle(ExecutionPolicy &&policy, RandomIt first, RandomIt last, URBG &g)
+      {
+        std::size_t n = last - first;
+        std::size_t blocks = std::bit_floor(std::max<std::size_t>(1, std::min(concurrency(policy), n/shuffle_grain)));
+
+        if (blocks == 1) {
+          random::shuffle(first, last, g);
+
+          return;
+        }
+
+        std::vector<std::uint64_t> seeds(2*blocks - 1);
+
+        for (auto &seed : seeds) {
+          seed = random::bits(g);
+        }
+
+        auto bound = [first, n, blocks](std::size_t block) {
+          return first + block*n/blocks;
+        };
+
+        for_each_chunk(policy, blocks, blocks, [&](std::size_t block, std::size_t, std::size_t) {
+            Xoshiro256 engine(seeds[block]);
+
+            random::shuffle(bound(block), bound(block + 1), engine);
+        });
+
+        std::size_t seed = blocks;
+
+        for (std::size_t width=1; width<blocks; width*=2) {
+          std::size_t merges = blocks/(2*width);
+
+          for_each_chunk(policy, merges, merges, [&](std::size_t merge, std::size_t, std::size_t) {
+              Xoshiro256 engine(seeds[seed + merge]);
+              std::size_t block = 2*width*merge;
+
+              random::merge_shuffled(bound(block), bound(block + width), bound(block + 2*width), engine);
+          });
+
+          seed = seed + merges;
+        }
+      }
+
+  }
+
+}
@@ -0,0 +1,404 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+
+// clang also defines __GNUC__; it needs version 10 for the conditional
+// operator on vectors
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__)) and (not defined(__clang__) or __clang_major__ >= 10)
+#define JMIXIN_SIMD_X86
+#endif
+
+namespace jmixin {
+
+  template<typename T>
+    struct MinMax {
+      T min;
+      T max;
+      std::size_t min_position;
+      std::size_t max_position;
+    };
+
+  // Reduction kernels for contiguous ranges of int32, int64, float and double.
+  // The kernels are written once with the gcc vector extensions and compiled
+  // for sse2 and avx2; the widest one the cpu supports is picked at runtime.
+  // They are built by gcc and clang 10 or later on x86; other compilers and
+  // targets always run the scalar loops (level() reports isa::scalar).
+  // Floating point results follow std::reduce, so the order of the operations
+  // is unspecified and NaNs are not supported.
+  namespace simd {
+
+    enum class isa {
+      scalar,
+      sse2,
+      avx2
+    };
+
+    template<typename T>
+      inline constexpr bool is_supported_v =
+        std::is_same_v<T, std::int32_t> or std::is_same_v<T, std::int64_t> or std::is_same_v<T, float> or std::is_same_v<T, double>;
+
+    template<typename Range>
+      inline constexpr bool is_simd_range_v = std::ranges::contiguous_range<const Range> and is_supported_v<std::ranges::range_value_t<Range>>;
+
+    template<typename Compare, typename T>
+      inline constexpr bool is_less_v = std::is_same_v<Compare, std::less<>> or std::is_same_v<Compare, std::less<T>>;
+
+    template<typename Operation, typename T>
+      inline constexpr bool is_plus_v = std::is_same_v<Operation, std::plus<>> or std::is_same_v<Operation, std::plus<T>>;
+
+    template<typename Operation, typename T>
+      inline constexpr bool is_multiplies_v = std::is_same_v<Operation, std::multiplies<>> or std::is_same_v<Operation, std::multiplies<T>>;
+
+    template<typename Iterator, typename T, typename Operation>
+      inline constexpr bool is_reducible_v = std::contiguous_iterator<Iterator> and std::is_same_v<std::iter_value_t<Iterator>, T> and
+        is_supported_v<T> and (is_plus_v<Operation, T> or is_multiplies_v<Operation, T>);
+
+    namespace detail {
+
+      inline isa detect()
+      {
+#ifdef JMIXIN_SIMD_X86
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2")) {
+          return isa::avx2;
+        }
+
+        if (__builtin_cpu_supports("sse2")) {
+          return isa::sse2;
+        }
+#endif
+
+        return isa::scalar;
+      }
+
+      inline std::atomic<isa> & current()
+      {
+        static std::atomic<isa> level {detect()};
+
+        return level;
+      }
+
+      template<typename T, std::size_t Bytes>
+        struct vector {
+          typedef T type __attribute__((vector_size(Bytes)));
+          typedef T unaligned __attribute__((vector_size(Bytes), aligned(sizeof(T)), may_alias));
+        };
+
+      template<typename T>
+        using index_t = std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+
+      // Two accumulators per kernel hide the latency of the vector operation.
+      // Vectors never cross a call (operations work in place), so nothing
+      // depends on the vector calling convention of the target.
+      template<typename T, std::size_t Bytes, typename Operation>
+        [[gnu::always_inline]] inline T fold(const T *data, std::size_t n, T identity, Operation operation)
+        {
+          using V = typename vector<T, Bytes>::type;
+          using U = typename vector<T, Bytes>::unaligned;
+
+          constexpr std::size_t lanes = Bytes/sizeof(T);
+
+          V a = V{} + identity;
+          V b = a;
+          std::size_t i = 0;
+
+          for (; i + 2*lanes <= n; i += 2*lanes) {
+            V x = *reinterpret_cast<const U *>(data + i);
+            V y = *reinterpret_cast<const U *>(data + i + lanes);
+
+            operation(a, x);
+            operation(b, y);
+          }
+
+          operation(a, b);
+
+          T result = identity;
+
+          for (std::size_t k=0; k<lanes; k++) {
+            operation(result, a[k]);
+          }
+
+          for (; i<n; i++) {
+            operation(result, data[i]);
+          }
+
+          return result;
+        }
+
+      // Each lane keeps its first minimum and first maximum and their
+      // indexes; ties between lanes are solved by the smallest index.
+      template<typename T, std::size_t Bytes>
+        [[gnu::always_inline]] inline MinMax<T> minmax(const T *data, std::size_t n)
+        {
+          using V = typename vector<T, Bytes>::type;
+          using U = typename vector<T, Bytes>::unaligned;
+          using I = typename vector<index_t<T>, Bytes>::type;
+
+          constexpr std::size_t lanes = Bytes/sizeof(T);
+
+          MinMax<T> result {data[0], data[0], 0, 0};
+          std::size_t i = 0;
+
+          if (n >= 2*lanes) {
+            V lo = *reinterpret_cast<const U *>(data);
+            V hi = lo;
+            I index;
+
+            for (std::size_t k=0; k<lanes; k++) {
+              index[k] = static_cast<index_t<T>>(k);
+            }
+
+            I lo_index = index;
+            I hi_index = index;
+
+            for (i=lanes; i + lanes <= n; i += lanes) {
+              V x = *reinterpret_cast<const U *>(data + i);
+
+              index += static_cast<index_t<T>>(lanes);
+
+              auto lt = x < lo;
+              auto gt = x > hi;
+
+              lo = lt ? x : lo;
+              lo_index = lt ? index : lo_index;
+              hi = gt ? x : hi;
+              hi_index = gt ? index : hi_index;
+            }
+
+            result = {lo[0], hi[0], static_cast<std::size_t>(lo_index[0]), static_cast<std::size_t>(hi_index[0])};
+
+            for (std::size_t k=1; k<lanes; k++) {
+              std::size_t position = lo_index[k];
+
+              if (lo[k] < result.min or (lo[k] == result.min and position < result.min_position)) {
+                result.min = lo[k];
+                result.min_position = position;
+              }
+
+              position = hi_index[k];
+
+              if (hi[k] > result.max or (hi[k] == result.max and position < result.max_position)) {
+                result.max = hi[k];
+                result.max_position = position;
+              }
+            }
+          }
+
+          for (; i<n; i++) {
+            if (data[i] < result.min) {
+              result.min = data[i];
+              result.min_position = i;
+            }
+
+            if (data[i] > result.max) {
+              result.max = data[i];
+              result.max_position = i;
+            }
+          }
+
+          return result;
+        }
+
+      struct add {
+        template<typename T>
+          [[gnu::always_inline]] void operator()(T &a, const T &b) const
+          {
+            a = a + b;
+          }
+      };
+
+      struct multiply {
+        template<typename T>
+          [[gnu::always_inline]] void operator()(T &a, const T &b) const
+          {
+            a = a * b;
+          }
+      };
+
+      struct lower {
+        template<typename T>
+          [[gnu::always_inline]] void operator()(T &a, const T &b) const
+          {
+            a = b < a ? b : a;
+          }
+      };
+
+      struct upper {
+        template<typename T>
+          [[gnu::always_inline]] void operator()(T &a, const T &b) const
+          {
+            a = a < b ? b : a;
+          }
+      };
+
+#ifdef JMIXIN_SIMD_X86
+      template<typename T, typename Operation>
+        [[gnu::target("avx2")]] T fold_avx2(const T *data, std::size_t n, T identity, Operation operation)
+        {
+          return fold<T, 32>(data, n, identity, operation);
+        }
+
+      template<typename T, typename Operation>
+        [[gnu::target("sse2")]] T fold_sse2(const T *data, std::size_t n, T identity, Operation operation)
+        {
+          return fold<T, 16>(data, n, identity, operation);
+        }
+
+      template<typename T>
+        [[gnu::target("avx2")]] MinMax<T> minmax_avx2(const T *data, std::size_t n)
+        {
+          return minmax<T, 32>(data, n);
+        }
+
+      template<typename T>
+        [[gnu::target("sse2")]] MinMax<T> minmax_sse2(const T *data, std::size_t n)
+        {
+          return minmax<T, 16>(data, n);
+        }
+#endif
+
+      template<typename T>
+        MinMax<T> minmax_scalar(const T *data, std::size_t n)
+        {
+          MinMax<T> result {data[0], data[0], 0, 0};
+
+          for (std::size_t i=1; i<n; i++) {
+            if (data[i] < result.min) {
+              result.min = data[i];
+              result.min_position = i;
+            }
+
+            if (data[i] > result.max) {
+              result.max = data[i];
+              result.max_position = i;
+            }
+          }
+
+          return result;
+        }
+
+      template<typename T>
+        MinMax<T> minmax_dispatch(const T *data, std::size_t n)
+        {
+#ifdef JMIXIN_SIMD_X86
+          switch (current().load(std::memory_order_relaxed)) {
+            case isa::avx2:
+              return minmax_avx2(data, n);
+            case isa::sse2:
+              return minmax_sse2(data, n);
+            default:
+              break;
+          }
+#endif
+
+          return minmax_scalar(data, n);
+        }
+
+      template<typename T, typename Operation>
+        T dispatch(const T *data, std::size_t n, T identity, Operation operation)
+        {
+#ifdef JMIXIN_SIMD_X86
+          switch (current().load(std::memory_order_relaxed)) {
+            case isa::avx2:
+              return fold_avx2(data, n, identity, operation);
+            case isa::sse2:
+              return fold_sse2(data, n, identity, operation);
+            default:
+              break;
+          }
+#endif
+
+          for (std::size_t i=0; i<n; i++) {
+            operation(identity, data[i]);
+          }
+
+          return identity;
+        }
+
+    }
+
+    inline isa level()
+    {
+      return detail::current().load(std::memory_order_relaxed);
+    }
+
+    // Caps the instruction set used by the kernels (mostly for tests and
+    // benchmarks); asking for more than the cpu supports has no effect.
+    inline void limit(isa level)
+    {
+      detail::current().store(std::min(level, detail::detect()), std::memory_order_relaxed);
+    }
+
+    template<typename T>
+      T sum(const T *data, std::size_t n)
+      {
+        return detail::dispatch(data, n, T{0}, detail::add());
+      }
+
+    template<typename T>
+      T product(const T *data, std::size_t n)
+      {
+        return detail::dispatch(data, n, T{1}, detail::multiply());
+      }
+
+    // min, max and minmax require n > 0.
+    template<typename T>
+      T min(const T *data, std::size_t n)
+      {
+        return detail::dispatch(data + 1, n - 1, data[0], detail::lower());
+      }
+
+    template<typename T>
+      T max(const T *data, std::size_t n)
+      {
+        return detail::dispatch(data + 1, n - 1, data[0], detail::upper());
+      }
+
+    template<typename T>
+      MinMax<T> minmax(const T *data, std::size_t n)
+      {
+        // blocks keep the lane indexes inside their integer type
+        constexpr std::size_t block = std::size_t{1} << 30;
+
+        MinMax<T> result {data[0], data[0], 0, 0};
+
+        for (std::size_t offset=0; offset<n; offset+=block) {
+          std::size_t count = std::min(block, n - offset);
+
+          MinMax<T> partial = detail::minmax_dispatch(data + offset, count);
+
+          if (partial.min < result.min) {
+            result.min = partial.min;
+            result.min_position = partial.min_position + offset;
+          }
+
+          if (partial.max > result.max) {
+            result.max = partial.max;
+            result.max_position = partial.max_position + offset;
+          }
+        }
+
+        return result;
+      }
+
+    template<typename T, typename Operation>
+      T reduce(const T *data, std::size_t n, T initial, Operation)
+      {
+        if constexpr (is_plus_v<Operation, T>) {
+          return initial + sum(data, n);
+        } else {
+          return initial * product(data, n);
+        }
+      }
+
+  }
+
+}
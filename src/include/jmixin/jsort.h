@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "jparallel.h"
+#include "jrandom.h"
+
+namespace jmixin {
+
+  // The sort engine: sort() picks an algorithm by the type of the items and
+  // the comparator, LSD radix sort for numbers in ascending or descending
+  // order, multikey quicksort for strings in ascending order and std::sort
+  // for anything else. The parallel versions split the items with a sample
+  // sort and sort the buckets with the same engine.
+  namespace sorting {
+
+    // Below it std::sort is faster than counting digits.
+    static constexpr std::size_t radix_threshold = 256;
+
+    template<typename T>
+      inline constexpr bool is_radix_key_v = std::is_arithmetic_v<T> and sizeof(T) <= sizeof(std::uint64_t);
+
+    // Only the string classes, whose operator< is the order of the bytes;
+    // pointers such as const char * convert to std::string_view but are
+    // ordered by address.
+    template<typename T>
+      inline constexpr bool is_string_key_v = std::is_base_of_v<std::string, T> or std::is_base_of_v<std::string_view, T>;
+
+    template<typename Compare, typename T>
+      inline constexpr bool is_less_v = std::is_same_v<Compare, std::less<>> or std::is_same_v<Compare, std::less<T>>;
+
+    template<typename Compare, typename T>
+      inline constexpr bool is_greater_v = std::is_same_v<Compare, std::greater<>> or std::is_same_v<Compare, std::greater<T>>;
+
+    template<std::size_t Size>
+      using unsigned_t = std::conditional_t<Size == 1, std::uint8_t,
+            std::conditional_t<Size == 2, std::uint16_t,
+            std::conditional_t<Size == 4, std::uint32_t, std::uint64_t>>>;
+
+    // Maps value to an unsigned integer with the same order: the sign bit of
+    // integers is flipped and negative floating points are complemented.
+    template<typename T>
+      unsigned_t<sizeof(T)> radix_key(T value)
+      {
+        using Unsigned = unsigned_t<sizeof(T)>;
+
+        constexpr Unsigned sign = Unsigned{1} << (8*sizeof(T) - 1);
+
+        if constexpr (std::is_floating_point_v<T>) {
+          Unsigned bits = std::bit_cast<Unsigned>(value);
+
+          return (bits & sign) != 0 ? static_cast<Unsigned>(~bits) : static_cast<Unsigned>(bits | sign);
+        } else if constexpr (std::is_signed_v<T>) {
+          return static_cast<Unsigned>(static_cast<Unsigned>(value) ^ sign);
+        } else {
+          return static_cast<Unsigned>(value);
+        }
+      }
+
+    // Stable LSD radix sort on the number key(item), a byte per pass; the
+    // bytes all items share are skipped, so small keys in wide types cost
+    // fewer passes. Descending swaps the order.
+    template<typename RandomIt, typename Key>
+      void radix_sort(RandomIt first, RandomIt last, Key key, bool descending = false)
+      {
+        using value_type = std::iter_value_t<RandomIt>;
+        using Unsigned = decltype(radix_key(key(*first)));
+
+        constexpr std::size_t passes = sizeof(Unsigned);
+
+        std::size_t n = last - first;
+
+        if (n < 2) {
+          return;
+        }
+
+        auto digits = [&key, descending](const value_type &item) {
+          Unsigned digits = radix_key(key(item));
+
+          return descending == true ? static_cast<Unsigned>(~digits) : digits;
+        };
+
+        std::vector<std::size_t> counts(passes*256);
+
+        for (auto i=first; i!=last; ++i) {
+          Unsigned value = digits(*i);
+
+          for (std::size_t pass=0; pass<passes; pass++) {
+            counts[pass*256 + ((value >> (8*pass)) & 0xff)]++;
+          }
+        }
+
+        std::vector<value_type> buffer(n);
+
+        bool swapped = false;
+
+        for (std::size_t pass=0; pass<passes; pass++) {
+          std::size_t *count = &counts[pass*256];
+
+          if (std::find(count, count + 256, n) != count + 256) {
+            continue;
+          }
+
+          std::size_t offset = 0;
+
+          for (std::size_t digit=0; digit<256; digit++) {
+            offset = offset + std::exchange(count[digit], offset);
+          }
+
+          auto scatter = [&](auto source, auto target) {
+            for (std::size_t i=0; i<n; i++) {
+              target[count[(digits(source[i]) >> (8*pass)) & 0xff]++] = std::move(source[i]);
+            }
+          };
+
+          if (swapped == false) {
+            scatter(first, std::begin(buffer));
+          } else {
+            scatter(std::begin(buffer), first);
+          }
+
+          swapped = not swapped;
+        }
+
+        if (swapped == true) {
+          std::move(std::begin(buffer), std::end(buffer), first);
+        }
+      }
+
+    // Bentley and Sedgewick's multikey quicksort: a three way partition on
+    // the character at depth, so the common prefixes are compared only once.
+    template<typename RandomIt>
+      void multikey_quicksort(RandomIt first, RandomIt last, std::size_t depth = 0)
+      {
+        auto at = [](const auto &item, std::size_t depth) -> int {
+          std::string_view view(item);
+
+          return depth < view.size() ? static_cast<unsigned char>(view[depth]) : -1;
+        };
+
+        while (last - first > 16) {
+          int a = at(*first, depth);
+          int b = at(first[(last - first)/2], depth);
+          int c = at(last[-1], depth);
+          int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+          RandomIt lower = first;
+          RandomIt i = first;
+          RandomIt upper = last;
+
+          while (i < upper) {
+            int character = at(*i, depth);
+
+            if (character < pivot) {
+              std::iter_swap(lower++, i++);
+            } else if (character > pivot) {
+              std::iter_swap(i, --upper);
+            } else {
+              ++i;
+            }
+          }
+
+          multikey_quicksort(first, lower, depth);
+          multikey_quicksort(upper, last, depth);
+
+          // the strings that ended are all equal
+          if (pivot < 0) {
+            return;
+          }
+
+          first = lower;
+          last = upper;
+          depth = depth + 1;
+        }
+
+        for (auto i=first; i<last; ++i) {
+          auto value = std::move(*i);
+          auto j = i;
+
+          for (; j != first and std::string_view(value).substr(depth) < std::string_view(j[-1]).substr(depth); --j) {
+            *j = std::move(j[-1]);
+          }
+
+          *j = std::move(value);
+        }
+      }
+
+    template<typename RandomIt, typename Compare>
+      void sort(RandomIt first, RandomIt last, Compare compare)
+      {
+        using value_type = std::iter_value_t<RandomIt>;
+
+        if constexpr (is_radix_key_v<value_type> and (is_less_v<Compare, value_type> or is_greater_v<Compare, value_type>)) {
+          if (static_cast<std::size_t>(last - first) >= radix_threshold) {
+            radix_sort(first, last, std::identity(), is_greater_v<Compare, value_type>);
+
+            return;
+          }
+        } else if constexpr (is_string_key_v<value_type> and is_less_v<Compare, value_type>) {
+          multikey_quicksort(first, last);
+
+          return;
+        }
+
+        std::sort(first, last, compare);
+      }
+
+    // Stable, by the order of key(item).
+    template<typename RandomIt, typename Key>
+      void sort_by(RandomIt first, RandomIt last, Key key)
+      {
+        using value_type = std::iter_value_t<RandomIt>;
+        using key_type = std::remove_cvref_t<std::invoke_result_t<Key &, const value_type &>>;
+
+        if constexpr (is_radix_key_v<key_type> and std::is_default_constructible_v<value_type>) {
+          if (static_cast<std::size_t>(last - first) >= radix_threshold) {
+            radix_sort(first, last, std::ref(key));
+
+            return;
+          }
+        }
+
+        std::stable_sort(first, last, [&key](const auto &a, const auto &b) {
+            return key(a) < key(b);
+        });
+      }
+
+  }
+
+  namespace parallel {
+
+    static constexpr std::size_t sort_grain = 1 << 15;
+    static constexpr std::size_t sort_oversampling = 32;
+
+    // Sample sort: splitters picked from a sorted sample put every item in a
+    // bucket, the buckets are moved into place (keeping the order of equal
+    // items) and sorted at the same time by sorter, which is stable if
+    // sorter is.
+    template<typename ExecutionPolicy, typename RandomIt, typename Compare, typename Sorter>
+      void sample_sort(ExecutionPolicy &&policy, RandomIt first, RandomIt last, Compare compare, Sorter sorter)
+      {
+        using value_type = std::iter_value_t<RandomIt>;
+
+        std::size_t n = last - first;
+        std::size_t buckets = std::min({n/sort_grain, 4*concurrency(policy), std::size_t{1} << 15});
+
+        if constexpr (std::is_default_constructible_v<value_type> and std::is_copy_constructible_v<value_type>) {
+          if (buckets > 1) {
+            Xoshiro256 engine(n);
+            std::vector<value_type> sample;
+
+            sample.reserve(buckets*sort_oversampling);
+
+            for (std::size_t i=0; i<buckets*sort_oversampling; i++) {
+              sample.push_back(first[random::bounded(engine, n)]);
+            }
+
+            std::sort(std::begin(sample), std::end(sample), compare);
+
+            std::vector<value_type> splitters;
+
+            for (std::size_t i=1; i<buckets; i++) {
+              splitters.push_back(sample[i*sort_oversampling]);
+            }
+
+            std::size_t blocks = chunks(policy, n);
+            std::vector<std::uint16_t> ids(n);
+            std::vector<std::size_t> offsets(blocks*buckets);
+
+            for_each_chunk(policy, n, blocks, [&](std::size_t block, std::size_t begin, std::size_t end) {
+                std::size_t *count = &offsets[block*buckets];
+
+                for (std::size_t i=begin; i<end; i++) {
+                  ids[i] = std::upper_bound(std::begin(splitters), std::end(splitters), first[i], compare) - std::begin(splitters);
+
+                  count[ids[i]]++;
+                }
+            });
+
+            std::vector<std::size_t> bounds(buckets + 1);
+            std::size_t offset = 0;
+
+            for (std::size_t bucket=0; bucket<buckets; bucket++) {
+              bounds[bucket] = offset;
+
+              for (std::size_t block=0; block<blocks; block++) {
+                offset = offset + std::exchange(offsets[block*buckets + bucket], offset);
+              }
+            }
+
+            bounds[buckets] = n;
+
+            std::vector<value_type> buffer(n);
+
+            for_each_chunk(policy, n, blocks, [&](std::size_t block, std::size_t begin, std::size_t end) {
+                std::size_t *offset = &offsets[block*buckets];
+
+                for (std::size_t i=begin; i<end; i++) {
+                  buffer[offset[ids[i]]++] = std::move(first[i]);
+                }
+            });
+
+            for_each_chunk(policy, buckets, buckets, [&](std::size_t bucket, std::size_t, std::size_t) {
+                auto begin = std::begin(buffer) + bounds[bucket];
+                auto end = std::begin(buffer) + bounds[bucket + 1];
+
+                sorter(begin, end);
+
+                std::move(begin, end, first + bounds[bucket]);
+            });
+
+            return;
+          }
+        }
+
+        sorter(first, last);
+      }
+
+    template<typename ExecutionPolicy, typename RandomIt, typename Compare>
+      void sort(ExecutionPolicy &&policy, RandomIt first, RandomIt last, Compare compare)
+      {
+        sample_sort(policy, first, last, compare, [&compare](auto begin, auto end) {
+            sorting::sort(begin, end, compare);
+        });
+      }
+
+    template<typename ExecutionPolicy, typename RandomIt, typename Key>
+      void sort_by(ExecutionPolicy &&policy, RandomIt first, RandomIt last, Key key)
+      {
+        auto compare = [&key](const auto &a, const auto &b) {
+          return key(a) < key(b);
+        };
+
+        sample_sort(policy, first, last, compare, [&key](auto begin, auto end) {
+            sorting::sort_by(begin, end, key);
+        });
+      }
+
+  }
+
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace jmixin {
+
+  // Tracing of the Iterator methods. The instrumentation is only compiled in
+  // with JMIXIN_JITERATOR_TRACE, otherwise the macros below expand to
+  // nothing; even then, a method records an event only when the calling
+  // thread has an active Session, so tracing is switched on per pipeline.
+  namespace trace {
+
+    // Process wide counters, for programs that replace the global operator
+    // new and call allocated() from it. Allocations of other threads that
+    // happen during a method are counted as well.
+    struct Allocations {
+      static inline std::atomic<std::size_t> count {0};
+      static inline std::atomic<std::size_t> bytes {0};
+    };
+
+    inline void allocated(std::size_t bytes)
+    {
+      Allocations::count.fetch_add(1, std::memory_order_relaxed);
+      Allocations::bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    struct Event {
+      const char *name;
+      std::size_t input;
+      std::size_t output;
+      std::chrono::nanoseconds start;
+      std::chrono::nanoseconds duration;
+      std::size_t allocations;
+      std::size_t bytes;
+      std::size_t depth;
+    };
+
+    // Receives the events of the methods called by this thread while it is
+    // alive, either in a callback or, when created with a path, in a Chrome
+    // trace event file (chrome://tracing, Perfetto) written at the end.
+    // Sessions nest: the innermost one gets the events.
+    class Session {
+
+      public:
+        using Callback = std::function<void(const Event &)>;
+
+        explicit Session(Callback callback):
+          _callback(std::move(callback))
+        {
+          active() = this;
+        }
+
+        explicit Session(std::string path):
+          _path(std::move(path))
+        {
+          active() = this;
+        }
+
+        Session(const Session &) = delete;
+
+        Session & operator=(const Session &) = delete;
+
+        ~Session()
+        {
+          active() = _previous;
+
+          if (_path.empty() == false) {
+            write();
+          }
+        }
+
+        static Session * current()
+        {
+          return active();
+        }
+
+        std::chrono::nanoseconds now() const
+        {
+          return std::chrono::steady_clock::now() - _begin;
+        }
+
+        std::size_t & depth()
+        {
+          return _depth;
+        }
+
+        void record(const Event &event)
+        {
+          if (_callback) {
+            _callback(event);
+          } else {
+            _events.push_back(event);
+          }
+        }
+
+      private:
+        Callback _callback;
+        std::string _path;
+        std::vector<Event> _events;
+        Session *_previous {active()};
+        std::chrono::steady_clock::time_point _begin {std::chrono::steady_clock::now()};
+        std::size_t _depth {0};
+
+        static Session * & active()
+        {
+          static thread_local Session *session = nullptr;
+
+          return session;
+        }
+
+        void write() const
+        {
+          std::ofstream out(_path);
+
+          if (!out) {
+            return;
+          }
+
+          std::size_t tid = std::hash<std::thread::id>()(std::this_thread::get_id()) % 100000;
+
+          out << "{\"traceEvents\": [";
+
+          for (std::size_t i=0; i<_events.size(); i++) {
+            const Event &event = _events[i];
+
+            out << (i == 0 ? "\n" : ",\n")
+              << "  {\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << tid
+              << ", \"ts\": " << event.start.count()/1000.0 << ", \"dur\": " << event.duration.count()/1000.0
+              << ", \"args\": {\"input\": " << event.input << ", \"output\": " << event.output
+              << ", \"allocations\": " << event.allocations << ", \"bytes\": " << event.bytes << "}}";
+          }
+
+          out << "\n]}\n";
+        }
+
+    };
+
+    // Records one method call, from its construction to its destruction.
+    // The output defaults to the size of the container once the method is
+    // done, which is right for the methods that change it in place.
+    class Span {
+
+      public:
+        template<typename Container>
+          Span(const char *name, const Container &container):
+            _session(Session::current())
+          {
+            if (_session == nullptr) {
+              return;
+            }
+
+            _container = &container;
+            _size = [](const void *container) -> std::size_t {
+              if constexpr (std::ranges::sized_range<const Container>) {
+                return std::ranges::size(*static_cast<const Container *>(container));
+              } else {
+                return 0;
+              }
+            };
+
+            _event.name = name;
+            _event.input = _size(_container);
+            _event.depth = _session->depth()++;
+            _event.allocations = Allocations::count.load(std::memory_order_relaxed);
+            _event.bytes = Allocations::bytes.load(std::memory_order_relaxed);
+            _event.start = _session->now();
+          }
+
+        Span(const Span &) = delete;
+
+        Span & operator=(const Span &) = delete;
+
+        ~Span()
+        {
+          if (_session == nullptr) {
+            return;
+          }
+
+          _event.duration = _session->now() - _event.start;
+          _event.allocations = Allocations::count.load(std::memory_order_relaxed) - _event.allocations;
+          _event.bytes = Allocations::bytes.load(std::memory_order_relaxed) - _event.bytes;
+
+          if (_container != nullptr) {
+            _event.output = _size(_container);
+          }
+
+          _session->depth()--;
+          _session->record(_event);
+        }
+
+        // Sets the output of methods that return a new container.
+        template<typename Result>
+          void output(const Result &result)
+          {
+            if (_session == nullptr) {
+              return;
+            }
+
+            if constexpr (std::ranges::sized_range<const Result>) {
+              _event.output = std::ranges::size(result);
+            } else {
+              _event.output = 1;
+            }
+
+            _container = nullptr;
+          }
+
+      private:
+        Session *_session;
+        const void *_container {nullptr};
+        std::size_t (*_size)(const void *) {nullptr};
+        Event _event {};
+
+    };
+
+  }
+
+}
+
+#ifdef JMIXIN_JITERATOR_TRACE
+#define JMIXIN_TRACE(name) jmixin::trace::Span jmixin_trace_span(name, *this)
+#define JMIXIN_TRACE_OUTPUT(result) jmixin_trace_span.output(result)
+#else
+#define JMIXIN_TRACE(name)
+#define JMIXIN_TRACE_OUTPUT(result)
+#endif
@@ -0,0 +1,88 @@
+#include "jmixin/jiterator.h"
+
+#include <list>
+#include <memory_resource>
+
+template<typename Container>
+bool is_in(const Container &container, jmixin::Arena &arena)
+{
+  return container.get_allocator().resource() == &arena;
+}
+
+int main()
+{
+  jmixin::Arena arena(1024, std::pmr::new_delete_resource());
+
+  // any allocation that escapes the arena throws
+  std::pmr::set_default_resource(std::pmr::null_memory_resource());
+
+  std::pmr::vector<int> items({5, 3, 8, 1, 9, 2, 7}, arena.allocator());
+
+  auto pipeline = jmixin::Iterator(items);
+
+  if (is_in(pipeline, arena) == false or is_in(pipeline.copy(), arena) == false or is_in(pipeline.copy_n(3), arena) == false) {
+    return 1;
+  }
+
+  auto mapped = pipeline.map([](int item) { return item*2; });
+
+  if (is_in(mapped, arena) == false or mapped != std::pmr::vector<int>({10, 6, 16, 2, 18, 4, 14}, arena.allocator())) {
+    return 1;
+  }
+
+  auto parts = pipeline.copy().partition([](int item) { return item % 2 == 0; });
+
+  if (is_in(parts[0], arena) == false or is_in(parts[1], arena) == false or parts[0].size() != 2) {
+    return 1;
+  }
+
+  auto nested = pipeline.breaks(3);
+
+  if (nested.size() != 3 or is_in(nested[2], arena) == false or is_in(nested.flatten(), arena) == false) {
+    return 1;
+  }
+
+  auto sorted = pipeline.copy().sort();
+
+  sorted.difference(std::vector<int>{2, 3}).merge(std::vector<int>{4, 6});
+
+  if (is_in(sorted, arena) == false or sorted != std::pmr::vector<int>({1, 4, 5, 6, 7, 8, 9}, arena.allocator())) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+
+  auto filtered = pipeline.copy().filter(jmixin::par(executor, 2), [](int item) { return item > 4; });
+
+  if (is_in(filtered, arena) == false or filtered.size() != 4) {
+    return 1;
+  }
+
+  if (is_in(pipeline.group_by([](int item) { return item % 2; })[0].second, arena) == false) {
+    return 1;
+  }
+
+  std::pmr::list<int> list({3, 1, 2}, arena.allocator());
+
+  if (is_in(jmixin::Iterator(list).map([](int item) { return item + 1; }), arena) == false) {
+    return 1;
+  }
+
+  if (arena.allocated() == 0) {
+    return 1;
+  }
+
+  std::pmr::set_default_resource(nullptr);
+
+  std::byte buffer[256];
+
+  jmixin::Arena local(buffer);
+
+  std::pmr::vector<int> small({1, 2, 3}, local.allocator());
+
+  if (jmixin::Iterator(small).map([](int item) { return item*item; }).back() != 9 or local.allocated() == 0) {
+    return 1;
+  }
+
+  return 0;
+}
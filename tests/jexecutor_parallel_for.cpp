@@ -0,0 +1,55 @@
+#include "jmixin/jexecutor.h"
+
+#include <stdexcept>
+
+int main()
+{
+  jmixin::Executor executor(4);
+
+  if (executor.workers() != 4) {
+    return 1;
+  }
+
+  std::vector<int> visits(100000);
+  std::atomic<std::size_t> largest {0};
+
+  executor.parallel_for(visits.size(), 1000, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t i=begin; i<end; i++) {
+        visits[i]++;
+      }
+
+      std::size_t current = largest.load();
+
+      while (end - begin > current and largest.compare_exchange_weak(current, end - begin) == false) {
+      }
+  });
+
+  if (std::count(std::begin(visits), std::end(visits), 1) != 100000 or largest > 1000) {
+    return 1;
+  }
+
+  std::atomic<std::size_t> total {0};
+
+  executor.parallel_for(8, 1, [&](std::size_t, std::size_t) {
+      executor.parallel_for(100, 10, [&](std::size_t begin, std::size_t end) {
+          total += end - begin;
+      });
+  });
+
+  if (total != 800) {
+    return 1;
+  }
+
+  try {
+    executor.parallel_for(100, 1, [](std::size_t begin, std::size_t) {
+        if (begin == 50) {
+          throw std::runtime_error("failure");
+        }
+    });
+
+    return 1;
+  } catch (std::runtime_error &) {
+  }
+
+  return 0;
+}
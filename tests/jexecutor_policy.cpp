@@ -0,0 +1,46 @@
+#include "jmixin/jiterator.h"
+
+int main()
+{
+  jmixin::Executor executor(4);
+
+  std::vector<int> items(100000);
+
+  std::iota(std::begin(items), std::end(items), 0);
+
+  auto policy = jmixin::par(executor, 512);
+
+  if (jmixin::Iterator(items).reverse(policy).sort(policy, std::less<>()) != items) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(items).count(policy, [](const auto &item) { return item % 2 == 0; }) != 50000) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(items).position(policy, [](const auto &item) { return item > 70000; }) != 70001u) {
+    return 1;
+  }
+
+  auto doubled = jmixin::Iterator(items)
+    .filter(policy, [](const auto &item) {
+        return item % 10 == 0;
+    })
+    .map(policy, [](const auto &item) {
+        return item*2;
+    });
+
+  if (doubled.size() != 10000 or doubled[1] != 20 or doubled.back() != 199980) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(items).left_rotate(policy, 3).take(policy, 2) != std::vector<int>{3, 4}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(items).eq(policy, items) == false or jmixin::Iterator(items).lt(policy, std::vector<int>{0, 2}) == false) {
+    return 1;
+  }
+
+  return 0;
+}
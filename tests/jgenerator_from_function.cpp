@@ -0,0 +1,54 @@
+#include "jmixin/jgenerator.h"
+#include "jmixin/jiterator.h"
+
+#include <random>
+
+int main()
+{
+  std::mt19937 generator {42};
+  std::size_t draws {0};
+
+  // only the draws the pipeline consumes are made
+  auto result = jmixin::from_function([&]() {
+        draws++;
+
+        return static_cast<int>(generator() % 100);
+    })
+    .lazy()
+    .filter([](int item) { return item < 50; })
+    .take(10)
+    .collect();
+
+  if (result.size() != 10 or result.all([](int item) { return item < 50; }) == false or draws < 10 or draws > 100) {
+    return 1;
+  }
+
+  auto countdown = jmixin::from_function([n=3]() mutable -> std::optional<int> {
+      if (n == 0) {
+        return std::nullopt;
+      }
+
+      return n--;
+  });
+
+  if (std::move(countdown).lazy().collect() != std::vector<int>{3, 2, 1}) {
+    return 1;
+  }
+
+  auto failing = jmixin::from_function([n=0]() mutable -> int {
+      if (n == 2) {
+        throw std::runtime_error("no more items");
+      }
+
+      return n++;
+  });
+
+  try {
+    std::move(failing).lazy().count();
+
+    return 1;
+  } catch (const std::runtime_error &) {
+  }
+
+  return 0;
+}
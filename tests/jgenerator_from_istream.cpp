@@ -0,0 +1,28 @@
+#include "jmixin/jgenerator.h"
+#include "jmixin/jiterator.h"
+
+#include <sstream>
+
+int main()
+{
+  std::istringstream numbers("4 8 15 16 23 42");
+
+  if (jmixin::from_istream<int>(numbers).lazy().filter([](int item) { return item % 2 == 0; }).collect() != std::vector<int>{4, 8, 16, 42}) {
+    return 1;
+  }
+
+  std::istringstream words("the quick brown fox");
+
+  // the stream is read only as far as the pipeline needs
+  if (jmixin::from_istream(words).lazy().take(2).collect() != std::vector<std::string>{"the", "quick"}) {
+    return 1;
+  }
+
+  std::string rest;
+
+  if (!(words >> rest) or rest != "brown") {
+    return 1;
+  }
+
+  return 0;
+}
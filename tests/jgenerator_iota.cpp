@@ -0,0 +1,37 @@
+#include "jmixin/jgenerator.h"
+#include "jmixin/jiterator.h"
+
+#include <ranges>
+
+int main()
+{
+  std::size_t calls {0};
+
+  auto result = jmixin::iota(1)
+    .lazy()
+    .filter([&calls](int item) {
+        calls++;
+
+        return item % 3 == 0;
+    })
+    .take(4)
+    .collect();
+
+  if (result != std::vector<int>{3, 6, 9, 12} or calls != 12) {
+    return 1;
+  }
+
+  std::vector<long> items;
+
+  for (auto item : jmixin::iota(5L, 9L)) {
+    items.push_back(item);
+  }
+
+  if (items != std::vector<long>{5, 6, 7, 8} or jmixin::iota(3, 3).lazy().count() != 0) {
+    return 1;
+  }
+
+  static_assert(std::ranges::input_range<jmixin::generator<int>>);
+
+  return 0;
+}
@@ -0,0 +1,17 @@
+#include "jmixin/jgenerator.h"
+#include "jmixin/jiterator.h"
+
+#include <string>
+
+int main()
+{
+  if (jmixin::repeat(std::string("ab")).lazy().take(3).collect() != std::vector<std::string>{"ab", "ab", "ab"}) {
+    return 1;
+  }
+
+  if (jmixin::repeat(7, 4).lazy().sum() != 28 or jmixin::repeat(7, 0).lazy().first().has_value() == true) {
+    return 1;
+  }
+
+  return 0;
+}
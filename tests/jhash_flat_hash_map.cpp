@@ -0,0 +1,42 @@
+#include "jmixin/jhash.h"
+
+#include <string>
+
+int main()
+{
+  jmixin::FlatHashMap<std::string, int> map;
+
+  map["b"] = 1;
+  map["a"] = 2;
+  map["b"] += 3;
+
+  if (map.size() != 2 or map.contains("c") == true or map.find("b")->second != 4) {
+    return 1;
+  }
+
+  if (map.begin()->first != "b" or std::next(map.begin())->first != "a") {
+    return 1;
+  }
+
+  if (map.try_emplace("a", 10).second == true or map["a"] != 2) {
+    return 1;
+  }
+
+  jmixin::FlatHashMap<int, int> numbers;
+
+  for (int i=0; i<10000; i++) {
+    numbers[i*7919 % 10007] = i;
+  }
+
+  for (int i=0; i<10000; i++) {
+    if (numbers.find(i*7919 % 10007)->second != i) {
+      return 1;
+    }
+  }
+
+  if (numbers.size() != 10000 or numbers.contains(-1) == true or numbers.find(-1) != numbers.end()) {
+    return 1;
+  }
+
+  return 0;
+}
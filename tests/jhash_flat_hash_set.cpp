@@ -0,0 +1,60 @@
+#include "jmixin/jhash.h"
+
+#include <string>
+
+// keys do not need a default constructor
+struct Id {
+  explicit Id(int value):
+    value(value)
+  {
+  }
+
+  bool operator==(const Id &) const = default;
+
+  int value;
+};
+
+struct IdHash {
+  std::size_t operator()(const Id &id) const
+  {
+    return static_cast<std::size_t>(id.value);
+  }
+};
+
+int main()
+{
+  jmixin::FlatHashSet<std::string> set;
+
+  if (set.contains("a") == true or set.index("a") != 0) {
+    return 1;
+  }
+
+  for (int i=0; i<1000; i++) {
+    if (set.insert(std::to_string(i)) != std::make_pair(std::size_t(i), true)) {
+      return 1;
+    }
+  }
+
+  if (set.insert("7") != std::make_pair(std::size_t(7), false) or set.size() != 1000 or set.index("999") != 999 or set.contains("1000") == true) {
+    return 1;
+  }
+
+  // the keys are kept in insertion order
+  auto keys = jmixin::make_set<int>(std::vector<int>{5, 3, 5, 1, 3});
+
+  if (std::vector<int>(std::begin(keys), std::end(keys)) != std::vector<int>{5, 3, 1}) {
+    return 1;
+  }
+
+  jmixin::FlatHashSet<Id, IdHash> ids;
+
+  for (int i=0; i<100; i++) {
+    ids.insert(Id(i % 40));
+  }
+
+  if (ids.size() != 40 or ids.index(Id(39)) != 39 or ids.contains(Id(40)) == true) {
+    return 1;
+  }
+
+  return 0;
+}
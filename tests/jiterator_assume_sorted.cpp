@@ -0,0 +1,82 @@
+#include "jmixin/jiterator.h"
+
+#include <list>
+#include <span>
+#include <utility>
+
+template<typename T>
+  concept reversible = requires (T &&items) {
+    std::forward<T>(items).reverse();
+  };
+
+template<typename T>
+  concept partitionable = requires (T &&items, bool (*predicate)(int)) {
+    std::forward<T>(items).partition(predicate);
+  };
+
+template<typename T>
+  concept stable_partitionable = requires (T &&items, bool (*predicate)(int)) {
+    std::forward<T>(items).stable_partition(predicate);
+  };
+
+template<typename T>
+  concept partition_viewable = requires (T &&items, bool (*predicate)(int)) {
+    std::forward<T>(items).partition_view(predicate);
+  };
+
+template<typename T, typename ExecutionPolicy>
+  concept partitionable_par = requires (T &&items, ExecutionPolicy policy, bool (*predicate)(int)) {
+    std::forward<T>(items).partition(policy, predicate);
+  };
+
+int main()
+{
+  auto result = jmixin::Iterator(std::list<int>{1, 2, 2, 3, 5, 7, 8})
+    .assume_sorted().unique().intersection(std::vector<int>{2, 3, 4, 7}).union_set(std::vector<int>{1, 9});
+
+  static_assert(std::is_same_v<decltype(result), jmixin::SortedIterator<std::list<int>>>);
+
+  if (result != std::list<int>{1, 2, 3, 7, 9}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<int>{9, 5, 1})
+    .assume_sorted(std::greater<>()).merge(std::vector<int>{8, 2}) != std::vector<int>{9, 8, 5, 2, 1}) {
+    return 1;
+  }
+
+  // the order breaking mutators are gone from lvalues and drop the type of rvalues
+  using Sorted = jmixin::SortedIterator<std::vector<int>>;
+
+  static_assert(reversible<Sorted &> == false);
+  static_assert(std::is_same_v<decltype(std::declval<Sorted>().reverse()), jmixin::Iterator<std::vector<int>>>);
+  static_assert(std::is_same_v<decltype(std::declval<Sorted &>().filter([](int) { return true; })), Sorted &>);
+
+  using Policy = decltype(jmixin::par(std::declval<jmixin::Executor &>()));
+
+  static_assert(partitionable<Sorted &> == false);
+  static_assert(stable_partitionable<Sorted &> == false);
+  static_assert(partitionable_par<Sorted &, Policy> == false);
+  static_assert(partition_viewable<Sorted &> == false);
+  static_assert(partition_viewable<Sorted> == false);
+  static_assert(std::is_same_v<decltype(std::declval<Sorted>().partition([](int) { return true; })), jmixin::Iterator<std::vector<std::vector<int>>>>);
+  static_assert(std::is_same_v<decltype(std::declval<Sorted &>().chunks(2))::value_type, std::span<const int>>);
+
+  auto parts = jmixin::Iterator(std::vector<int>{5, 1, 4, 2, 3, 6}).sort().stable_partition([](int item) { return item % 2 == 0; });
+
+  if (parts != std::vector<std::vector<int>>{{2, 4, 6}, {1, 3, 5}}) {
+    return 1;
+  }
+
+  auto sorted = jmixin::Iterator(std::vector<int>{1, 2, 4, 8}).assume_sorted();
+
+  if (sorted.take(3).contains(4) == false or sorted.contains(8) == true) {
+    return 1;
+  }
+
+  if (std::move(sorted).reverse() != std::vector<int>{4, 2, 1}) {
+    return 1;
+  }
+
+  return 0;
+}
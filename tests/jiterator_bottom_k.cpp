@@ -0,0 +1,25 @@
+#include "jmixin/jiterator.h"
+
+#include <list>
+
+int main()
+{
+  if (jmixin::Iterator(std::list<std::string>{"pear", "fig", "apple", "plum", "kiwi"})
+    .bottom_k(2) != std::list<std::string>{"apple", "fig"}) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+
+  std::vector<int> items(10000);
+
+  std::iota(std::begin(items), std::end(items), 0);
+  std::shuffle(std::begin(items), std::end(items), std::mt19937{42});
+
+  if (jmixin::Iterator(items)
+    .bottom_k(jmixin::par(executor, 100), 3, std::less<>()) != std::vector<int>{0, 1, 2}) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,34 @@
+#include "jmixin/jiterator.h"
+
+#include <list>
+
+int main()
+{
+  auto items = jmixin::Iterator(std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9});
+  auto chunks = items.chunks(4);
+
+  static_assert(std::is_same_v<decltype(chunks)::value_type, std::span<int>>);
+
+  if (chunks.size() != 3 or chunks[0].data() != items.data() or chunks[2].size() != 1) {
+    return 1;
+  }
+
+  chunks[1][0] = 50;
+
+  if (items[4] != 50) {
+    return 1;
+  }
+
+  auto list = jmixin::Iterator(std::list<int>{1, 2, 3, 4, 5});
+  std::vector<int> sizes;
+
+  for (auto chunk : list.chunks(2)) {
+    sizes.push_back(std::ranges::distance(chunk));
+  }
+
+  if (sizes != std::vector<int>{2, 2, 1}) {
+    return 1;
+  }
+
+  return 0;
+}
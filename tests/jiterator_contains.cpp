@@ -0,0 +1,20 @@
+#include "jmixin/jiterator.h"
+
+#include <set>
+
+int main()
+{
+  auto items = jmixin::Iterator(std::vector<int>{5, 9, 1, 6, 7, 3}).sort();
+
+  if (items.contains(6) == false or items.contains(4) == true) {
+    return 1;
+  }
+
+  auto unique = jmixin::Iterator(std::set<int>{1, 3, 5}).assume_sorted();
+
+  if (unique.contains(3) == false or unique.contains(2) == true) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+#include "jmixin/jiterator.h"
+
+#include <atomic>
+#include <list>
+#include <string>
+
+int main()
+{
+  if (jmixin::Iterator(std::vector<int>{3, 1, 3, 2, 1, 3})
+    .count_by([](int item) { return item; }) != std::vector<std::pair<int, std::size_t>>{{3, 3}, {1, 2}, {2, 1}}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::list<std::string>{"one", "two", "three", "four"})
+    .count_by([](const std::string &item) { return item.size(); }) != std::vector<std::pair<std::size_t, std::size_t>>{{3, 2}, {5, 1}, {4, 1}}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<long>{-1000000000000, 1000000000000, -1000000000000})
+    .count_by([](long item) { return item; }) != std::vector<std::pair<long, std::size_t>>{{-1000000000000, 2}, {1000000000000, 1}}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<int>{}).count_by([](int item) { return item; }).empty() == false) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+
+  std::vector<int> items(10000);
+
+  for (std::size_t i=0; i<items.size(); i++) {
+    items[i] = (i*31) % 7;
+  }
+
+  auto counts = jmixin::Iterator(items)
+    .count_by(jmixin::par(executor, 100), [](int item) { return item; });
+
+  if (counts != jmixin::Iterator(items).count_by([](int item) { return item; })) {
+    return 1;
+  }
+
+  // integral keys are computed once per item, bounds included
+  std::atomic<std::size_t> calls = 0;
+  auto counted = [&calls](int item) {
+    calls++;
+
+    return item;
+  };
+
+  if (jmixin::Iterator(items).count_by(counted) != counts or calls != items.size()) {
+    return 1;
+  }
+
+  calls = 0;
+
+  if (jmixin::Iterator(items).count_by(jmixin::par(executor, 100), counted) != counts or calls != items.size()) {
+    return 1;
+  }
+
+  auto strings = jmixin::Iterator(items)
+    .count_by(jmixin::par(executor, 100), [](int item) { return std::to_string(item*item); });
+
+  if (strings.size() != 7 or strings[0] != std::pair<std::string, std::size_t>{"0", 1429}) {
+    return 1;
+  }
+
+  return 0;
+}
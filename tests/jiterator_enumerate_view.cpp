@@ -0,0 +1,44 @@
+#include "jmixin/jiterator.h"
+
+#include <list>
+
+template<typename T>
+  concept enumerable = requires (T &&items) {
+    std::forward<T>(items).enumerate_view();
+  };
+
+int main()
+{
+  jmixin::Iterator<std::list<std::string>> items {std::list<std::string>{"a", "b", "c", "d"}};
+
+  auto result = items.enumerate_view()
+    .filter([](const auto &item) {
+        return std::get<0>(item) % 2 == 1;
+    })
+    .map([](const auto &item) {
+        return std::get<1>(item) + std::to_string(std::get<0>(item));
+    })
+    .collect();
+
+  if (result != std::vector<std::string>{"b1", "d3"}) {
+    return 1;
+  }
+
+  if (&std::get<1>(*items.enumerate_view().first()) != &items.front()) {
+    return 1;
+  }
+
+  jmixin::Iterator numbers(std::vector<int>{5, 6, 7});
+
+  if (numbers.enumerate_view().map([](const auto &item) {
+      return std::get<0>(item)*std::get<1>(item);
+    }).sum() != 0 + 6 + 14) {
+    return 1;
+  }
+
+  // the references would outlive a temporary
+  static_assert(enumerable<jmixin::Iterator<std::vector<int>> &>);
+  static_assert(enumerable<jmixin::Iterator<std::vector<int>>> == false);
+
+  return 0;
+}
@@ -0,0 +1,12 @@
+#include "jmixin/jiterator.h"
+
+int main()
+{
+  auto items = jmixin::Iterator(std::vector<int>{3, 1, 2, 3, 5, 3}).sort();
+
+  if (items.equal_range(3).size() != 3 or items.equal_range(4).empty() == false) {
+    return 1;
+  }
+
+  return 0;
+}
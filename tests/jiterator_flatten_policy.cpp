@@ -0,0 +1,28 @@
+#include "jmixin/jiterator.h"
+
+#include <vector>
+
+int main()
+{
+  jmixin::Executor executor(2);
+
+  std::vector<std::vector<int>> items;
+  std::vector<int> expected;
+
+  for (int i=0; i<100; i++) {
+    items.emplace_back(i % 7 == 0 ? 0 : i*13, i);
+
+    expected.insert(std::end(expected), i % 7 == 0 ? 0 : i*13, i);
+  }
+
+  // the result is presized from the inner sizes
+  if (jmixin::Iterator(items).flatten() != expected) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(items).flatten(jmixin::par(executor, 64)) != expected) {
+    return 1;
+  }
+
+  return 0;
+}
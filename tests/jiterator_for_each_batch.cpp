@@ -0,0 +1,60 @@
+#include <list>
+#include <map>
+
+#include "jmixin/jiterator.h"
+
+#include <atomic>
+#include <span>
+
+int main()
+{
+  std::vector<std::vector<int>> batches;
+
+  jmixin::Iterator(std::vector<int>{1, 2, 3, 4, 5, 6, 7})
+    .for_each_batch(3, [&batches](std::span<const int> batch) {
+        batches.emplace_back(std::begin(batch), std::end(batch));
+    });
+
+  if (batches != std::vector<std::vector<int>>{{1, 2, 3}, {4, 5, 6}, {7}}) {
+    return 1;
+  }
+
+  // not contiguous, the batches are buffered
+  batches.clear();
+
+  jmixin::Iterator(std::list<int>{1, 2, 3, 4, 5})
+    .for_each_batch(2, [&batches](std::span<const int> batch) {
+        batches.emplace_back(std::begin(batch), std::end(batch));
+    });
+
+  if (batches != std::vector<std::vector<int>>{{1, 2}, {3, 4}, {5}}) {
+    return 1;
+  }
+
+  std::size_t keys = 0;
+
+  jmixin::Iterator(std::map<int, int>{{1, 1}, {2, 2}, {3, 3}})
+    .for_each_batch(2, [&keys](std::span<const std::pair<const int, int>> batch) {
+        keys += batch.size();
+    });
+
+  if (keys != 3) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+  std::atomic<int> sum {0};
+  std::atomic<int> count {0};
+
+  jmixin::Iterator(std::list<int>(1000, 1))
+    .for_each_batch(jmixin::par(executor), 64, [&](std::span<const int> batch) {
+        sum += std::accumulate(std::begin(batch), std::end(batch), 0);
+        count++;
+    });
+
+  if (sum != 1000 or count != 16) {
+    return 1;
+  }
+
+  return 0;
+}
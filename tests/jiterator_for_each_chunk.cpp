@@ -0,0 +1,33 @@
+#include "jmixin/jiterator.h"
+
+#include <atomic>
+
+int main()
+{
+  std::vector<int> sizes;
+
+  jmixin::Iterator(std::vector<int>{1, 2, 3, 4, 5, 6, 7})
+    .for_each_chunk(3, [&sizes](auto chunk) {
+        sizes.push_back(chunk.size());
+    });
+
+  if (sizes != std::vector<int>{3, 3, 1}) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+  std::atomic<int> sum {0};
+  std::atomic<int> count {0};
+
+  jmixin::Iterator(std::vector<int>(1000, 1))
+    .for_each_chunk(jmixin::par(executor), 64, [&](auto chunk) {
+        sum += std::accumulate(std::begin(chunk), std::end(chunk), 0);
+        count++;
+    });
+
+  if (sum != 1000 or count != 16) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,35 @@
+#include "jmixin/jiterator.h"
+
+#include <set>
+
+int main()
+{
+  if (jmixin::Iterator(std::vector<int>{1, 2, 3, 4, 5, 6, 7})
+    .group_by([](int item) { return item % 3; }) != std::vector<std::pair<int, std::vector<int>>>{{1, {1, 4, 7}}, {2, {2, 5}}, {0, {3, 6}}}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::set<int>{7, 1, 4, 2})
+    .group_by([](int item) { return item % 2 == 0; }) != std::vector<std::pair<bool, std::set<int>>>{{false, {1, 7}}, {true, {2, 4}}}) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+
+  std::vector<int> items(10000);
+
+  std::iota(std::begin(items), std::end(items), 0);
+
+  auto groups = jmixin::Iterator(items)
+    .group_by(jmixin::par(executor, 100), [](int item) { return item % 10; });
+
+  if (groups != jmixin::Iterator(items).group_by([](int item) { return item % 10; })) {
+    return 1;
+  }
+
+  if (groups.size() != 10 or groups[3].second.size() != 1000 or std::is_sorted(std::begin(groups[3].second), std::end(groups[3].second)) == false) {
+    return 1;
+  }
+
+  return 0;
+}
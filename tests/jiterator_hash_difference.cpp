@@ -0,0 +1,32 @@
+#include <list>
+
+#include "jmixin/jiterator.h"
+
+int main()
+{
+  if (jmixin::Iterator(std::vector<int>{9, 4, 1, 7, 4, 8})
+    .hash_difference(std::vector<int>{8, 4}) != std::vector<int>{9, 1, 7}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<int>{9, 4, 1})
+    .hash_difference(std::list<int>{1, 2, 3, 4, 5, 6}) != std::vector<int>{9}) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+
+  std::vector<int> items(50000);
+  std::vector<int> other(100000);
+
+  std::iota(std::begin(items), std::end(items), 0);
+  std::iota(std::begin(other), std::end(other), 25000);
+
+  auto result = jmixin::Iterator(items).hash_difference(jmixin::par(executor), other);
+
+  if (result.size() != 25000 or result.back() != 24999 or result != jmixin::Iterator(items).hash_difference(other)) {
+    return 1;
+  }
+
+  return 0;
+}
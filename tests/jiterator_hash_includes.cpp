@@ -0,0 +1,28 @@
+#include <list>
+
+#include "jmixin/jiterator.h"
+
+int main()
+{
+  jmixin::Iterator<std::vector<int>> items(std::vector<int>{9, 4, 1, 7, 4, 8});
+
+  if (items.hash_includes(std::vector<int>{8, 4, 4}) == false or items.hash_includes(std::vector<int>{8, 5}) == true) {
+    return 1;
+  }
+
+  if (items.hash_includes(std::list<int>{1, 4, 7, 8, 9, 1, 4, 7, 8, 9}) == false or items.hash_includes(std::list<int>(10, 2)) == true) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+
+  std::vector<int> large(100000);
+
+  std::iota(std::begin(large), std::end(large), 0);
+
+  if (jmixin::Iterator(large).hash_includes(jmixin::par(executor), std::vector<int>{99999, 0}) == false or items.hash_includes(jmixin::par(executor), large) == true) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,40 @@
+#include <list>
+
+#include "jmixin/jiterator.h"
+
+#include <string>
+
+int main()
+{
+  // both ways of building the set keep the order of the items
+  if (jmixin::Iterator(std::vector<int>{9, 4, 1, 7, 4, 8})
+    .hash_intersection(std::vector<int>{8, 4, 7}) != std::vector<int>{4, 7, 4, 8}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<int>{9, 4, 1})
+    .hash_intersection(std::list<int>{1, 2, 3, 4, 5, 6}) != std::vector<int>{4, 1}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<std::string>{"b", "a", "c"})
+    .hash_intersection(std::vector<std::string>{}).empty() == false) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+
+  std::vector<int> items(50000);
+  std::vector<int> other(100000);
+
+  std::iota(std::begin(items), std::end(items), 0);
+  std::iota(std::begin(other), std::end(other), 25000);
+
+  auto result = jmixin::Iterator(items).hash_intersection(jmixin::par(executor), other);
+
+  if (result.size() != 25000 or result.front() != 25000 or result != jmixin::Iterator(items).hash_intersection(other)) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,33 @@
+#include <list>
+
+#include "jmixin/jiterator.h"
+
+int main()
+{
+  // other is the smaller side
+  if (jmixin::Iterator(std::vector<int>{9, 4, 1, 7})
+    .hash_union(std::vector<int>{3, 4, 3}) != std::vector<int>{9, 4, 1, 7, 3}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<int>{2, 1})
+    .hash_union(std::list<int>{5, 1, 5, 6, 2}) != std::vector<int>{2, 1, 5, 6}) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+
+  std::vector<int> items(100000);
+  std::vector<int> other(50000);
+
+  std::iota(std::begin(items), std::end(items), 0);
+  std::iota(std::begin(other), std::end(other), 75000);
+
+  auto result = jmixin::Iterator(items).hash_union(jmixin::par(executor), other);
+
+  if (result.size() != 125000 or result.back() != 124999 or result != jmixin::Iterator(items).hash_union(other)) {
+    return 1;
+  }
+
+  return 0;
+}
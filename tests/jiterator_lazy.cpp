@@ -0,0 +1,45 @@
+#include "jmixin/jiterator.h"
+
+#include <list>
+
+int main()
+{
+  std::size_t calls {0};
+
+  auto result = jmixin::Iterator(std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9})
+    .lazy()
+    .filter([&calls](const auto &item) {
+        calls++;
+
+        return item % 2 == 0;
+    })
+    .map([](const auto &item) {
+        return item*10;
+    })
+    .take(2)
+    .collect();
+
+  if (result != std::vector<int>{20, 40} or calls != 4) {
+    return 1;
+  }
+
+  jmixin::Iterator<std::list<int>> items {std::list<int>{1, 2, 3, 4, 5, 6, 7, 8, 9}};
+
+  if (items.lazy().skip(2).step(3).sum() != 3 + 6 + 9) {
+    return 1;
+  }
+
+  if (items.lazy().find_first([](const auto &item) { return item > 4; }) != 5) {
+    return 1;
+  }
+
+  if (items.lazy().filter([](const auto &item) { return item > 9; }).first().has_value() == true) {
+    return 1;
+  }
+
+  if (items.lazy().take(0).count() != 0 or items.size() != 9) {
+    return 1;
+  }
+
+  return 0;
+}
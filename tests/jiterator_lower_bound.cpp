@@ -0,0 +1,12 @@
+#include "jmixin/jiterator.h"
+
+int main()
+{
+  auto items = jmixin::Iterator(std::vector<int>{1, 3, 5, 7, 9}).assume_sorted();
+
+  if (*items.lower_bound(4) != 5 or *items.lower_bound(5) != 5 or items.lower_bound(10) != std::end(items)) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include "jmixin/jiterator.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+int main()
+{
+  if (jmixin::Iterator(std::vector<std::vector<int>>{{1, 5, 9}, {2, 6}, {}, {0, 5, 10}})
+    .merge_all() != std::vector<int>{0, 1, 2, 5, 5, 6, 9, 10}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<std::vector<int>>{{9, 5, 1}, {6, 2}})
+    .merge_all(std::greater<>()) != std::vector<int>{9, 6, 5, 2, 1}) {
+    return 1;
+  }
+
+  if (jmixin::merge_all(std::vector<int>{3, 4}, std::vector<int>{1, 8}, std::vector<int>{2}) != std::vector<int>{1, 2, 3, 4, 8}) {
+    return 1;
+  }
+
+  // many sorted runs, merged by splitter keys
+  jmixin::Executor executor(3);
+  jmixin::Xoshiro256 engine(3);
+  std::vector<std::vector<int>> runs(64);
+  std::vector<int> expected;
+
+  for (auto &run : runs) {
+    run.resize(jmixin::random::bounded(engine, 2000));
+
+    for (auto &item : run) {
+      item = static_cast<int>(engine() % 500);
+    }
+
+    std::sort(std::begin(run), std::end(run));
+
+    expected.insert(std::end(expected), std::begin(run), std::end(run));
+  }
+
+  std::sort(std::begin(expected), std::end(expected));
+
+  for (std::size_t grain : {1, 100, 1000000}) {
+    if (jmixin::Iterator(runs).merge_all(jmixin::par(executor, grain), std::less<>()) != expected) {
+      return 1;
+    }
+  }
+
+  if (jmixin::Iterator(runs).merge_all() != expected) {
+    return 1;
+  }
+
+  // the policy alone picks the parallel overload with the default compare
+  if (jmixin::Iterator(runs).merge_all(jmixin::par(executor)) != expected) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<std::vector<int>>{{9, 5, 1}, {6, 2}})
+    .merge_all(jmixin::par(executor, 1), std::greater<>()) != std::vector<int>{9, 6, 5, 2, 1}) {
+    return 1;
+  }
+
+  return 0;
+}
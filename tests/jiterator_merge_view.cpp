@@ -0,0 +1,23 @@
+#include "jmixin/jiterator.h"
+
+#include <vector>
+
+int main()
+{
+  jmixin::Iterator runs(std::vector<std::vector<int>>{{1, 5, 9}, {2, 6}, {0, 5, 10}});
+
+  if (runs.merge_view().collect() != std::vector<int>{0, 1, 2, 5, 5, 6, 9, 10}) {
+    return 1;
+  }
+
+  // only the items needed are merged
+  if (runs.merge_view().filter([](int item) { return item > 4; }).take(2).collect() != std::vector<int>{5, 5}) {
+    return 1;
+  }
+
+  if (std::move(runs).merge_view().count() != 8) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,24 @@
+#include "jmixin/jiterator.h"
+
+#include <list>
+
+int main()
+{
+  auto result = jmixin::Iterator(std::vector<int>{5, 1, 9, 3, 1, 9, 7, 2, 8, 6, 4, 0, 9, 3, 2, 1, 5}).minmax();
+
+  if (result->min != 0 or result->min_position != 11 or result->max != 9 or result->max_position != 2) {
+    return 1;
+  }
+
+  auto words = jmixin::Iterator(std::list<std::string>{"pear", "apple", "plum", "fig"}).minmax();
+
+  if (words->min != "apple" or words->min_position != 1 or words->max != "plum" or words->max_position != 2) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<double>{}).minmax().has_value() == true) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,58 @@
+#include "jmixin/jiterator.h"
+
+#include <cstdlib>
+#include <new>
+
+static std::size_t allocations {0};
+
+void * operator new(std::size_t size)
+{
+  allocations++;
+
+  if (void *ptr = std::malloc(size)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+int main()
+{
+  std::vector<int> source {5, 9, 1, 6, 7, 8, 3, 2, 4, 10, 12, 11};
+
+  auto data = source.data();
+  auto before = allocations;
+
+  // every stage works in place: sort() is left out since it takes scratch
+  // memory for radix sort from sorting::radix_threshold items up
+  auto result = jmixin::Iterator(std::vector<int>(std::move(source)))
+    .filter([](const auto &item) {
+        return item % 2 == 0;
+    })
+    .left_rotate(2)
+    .reverse()
+    .take(4)
+    .skip(1);
+
+  if (allocations != before) {
+    return 1;
+  }
+
+  static_assert(std::is_same_v<decltype(result), jmixin::Iterator<std::vector<int>>>);
+
+  if (result.data() != data or result != std::vector<int>{6, 12, 10}) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include "jmixin/jiterator.h"
+
+#include <algorithm>
+#include <vector>
+
+int main()
+{
+  jmixin::Iterator items(std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+  auto [even, odd] = items.partition_view([](const auto &item) {
+      return item % 2 == 0;
+  });
+
+  // the views share the storage of items
+  if (even.size() != 4 or odd.size() != 5 or even.begin() != items.begin() or odd.end() != items.end()) {
+    return 1;
+  }
+
+  if (std::all_of(even.begin(), even.end(), [](int item) { return item % 2 == 0; }) == false) {
+    return 1;
+  }
+
+  if (std::none_of(odd.begin(), odd.end(), [](int item) { return item % 2 == 0; }) == false) {
+    return 1;
+  }
+
+  // block partition, with chunks that end up on both sides of the split
+  jmixin::Executor executor(3);
+  jmixin::Xoshiro256 engine(5);
+
+  for (std::size_t grain : {1, 10, 1000, 1000000}) {
+    std::vector<int> values(100000);
+
+    for (auto &value : values) {
+      value = static_cast<int>(engine() % 1000);
+    }
+
+    auto expected = values;
+    auto hot = [](int value) { return value < 300; };
+
+    jmixin::Iterator records(values);
+
+    auto [first, second] = records.partition_view(jmixin::par(executor, grain), hot);
+
+    if (first.size() != static_cast<std::size_t>(std::count_if(std::begin(expected), std::end(expected), hot))) {
+      return 1;
+    }
+
+    if (std::all_of(first.begin(), first.end(), hot) == false or std::any_of(second.begin(), second.end(), hot) == true) {
+      return 1;
+    }
+
+    std::sort(std::begin(expected), std::end(expected));
+    std::sort(std::begin(records), std::end(records));
+
+    if (records != expected) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,35 @@
+#include "jmixin/jiterator.h"
+
+#include <string>
+
+int main()
+{
+  std::vector<std::pair<std::string, int>> sales {{"b", 2}, {"a", 5}, {"b", 7}, {"c", 1}, {"a", 1}};
+
+  auto key = [](const auto &item) { return item.first; };
+  auto add = [](int value, const auto &item) { return value + item.second; };
+
+  if (jmixin::Iterator(sales).reduce_by_key(key, add, 0) != std::vector<std::pair<std::string, int>>{{"b", 9}, {"a", 6}, {"c", 1}}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<int>{4, 9, 2, 7})
+    .reduce_by_key([](int item) { return item % 2; }, [](int value, int item) { return std::max(value, item); }) != std::vector<std::pair<int, int>>{{0, 4}, {1, 9}}) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+
+  std::vector<int> items(10000);
+
+  std::iota(std::begin(items), std::end(items), 0);
+
+  auto sums = jmixin::Iterator(items)
+    .reduce_by_key(jmixin::par(executor, 100), [](int item) { return item % 4; }, std::plus<>(), 0L);
+
+  if (sums != std::vector<std::pair<int, long>>{{0, 12495000}, {1, 12497500}, {2, 12500000}, {3, 12502500}}) {
+    return 1;
+  }
+
+  return 0;
+}
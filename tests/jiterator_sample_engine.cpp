@@ -0,0 +1,18 @@
+#include "jmixin/jiterator.h"
+
+#include <algorithm>
+#include <list>
+
+int main()
+{
+  jmixin::Iterator<std::list<int>> items(std::list<int>{1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+  // the same seed gives the same sample, in the order of the items
+  auto sample = items.sample(4, jmixin::Xoshiro256(3));
+
+  if (sample.size() != 4 or sample != items.sample(4, jmixin::Xoshiro256(3)) or std::is_sorted(std::begin(sample), std::end(sample)) == false) {
+    return 1;
+  }
+
+  return 0;
+}
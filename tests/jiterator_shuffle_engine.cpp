@@ -0,0 +1,24 @@
+#include "jmixin/jiterator.h"
+
+#include <numeric>
+#include <random>
+
+int main()
+{
+  jmixin::Iterator<std::vector<int>> items(std::vector<int>(100));
+
+  std::iota(std::begin(items), std::end(items), 0);
+
+  // the same seed gives the same order
+  jmixin::Xoshiro256 engine(42);
+
+  if (jmixin::Iterator(items).shuffle(engine) != jmixin::Iterator(items).shuffle(jmixin::Xoshiro256(42))) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(items).shuffle(std::mt19937(1)).sort() != items) {
+    return 1;
+  }
+
+  return 0;
+}
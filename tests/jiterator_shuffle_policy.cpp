@@ -0,0 +1,25 @@
+#include "jmixin/jiterator.h"
+
+#include <numeric>
+
+int main()
+{
+  jmixin::Executor executor(3);
+
+  std::vector<int> large(100000);
+
+  std::iota(std::begin(large), std::end(large), 0);
+
+  // merge shuffle: the same seed gives the same order for any split
+  auto shuffled = jmixin::Iterator(large).shuffle(jmixin::par(executor), jmixin::Xoshiro256(1));
+
+  if (shuffled == large or shuffled != jmixin::Iterator(large).shuffle(jmixin::par(executor), jmixin::Xoshiro256(1))) {
+    return 1;
+  }
+
+  if (shuffled.sort() != large or jmixin::Iterator(large).shuffle(jmixin::par(executor)).sort() != large) {
+    return 1;
+  }
+
+  return 0;
+}
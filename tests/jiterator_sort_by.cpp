@@ -0,0 +1,41 @@
+#include "jmixin/jiterator.h"
+
+#include <string>
+
+struct Person {
+  std::string name;
+  int age;
+
+  bool operator==(const Person &) const = default;
+};
+
+int main()
+{
+  auto people = jmixin::Iterator(std::vector<Person>{{"ana", 30}, {"bia", 25}, {"caio", 30}, {"davi", 20}})
+    .sort_by([](const Person &person) { return person.age; });
+
+  if (people != std::vector<Person>{{"davi", 20}, {"bia", 25}, {"ana", 30}, {"caio", 30}}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<std::string>{"ccc", "a", "bb"}).sort_by([](const std::string &item) { return item.size(); }) != std::vector<std::string>{"a", "bb", "ccc"}) {
+    return 1;
+  }
+
+  // large enough for the radix and sample sorts, the order of equal keys is kept
+  std::vector<std::pair<int, int>> items;
+
+  for (int i=0; i<100000; i++) {
+    items.emplace_back((i*7919) % 1000, i);
+  }
+
+  jmixin::Executor executor(3);
+
+  auto sorted = jmixin::Iterator(items).sort_by(jmixin::par(executor), [](const auto &item) { return item.first; });
+
+  if (std::is_sorted(std::begin(sorted), std::end(sorted)) == false or sorted != jmixin::Iterator(items).sort_by([](const auto &item) { return item.first; })) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,34 @@
+#include "jmixin/jiterator.h"
+
+#include <list>
+
+int main()
+{
+  if (jmixin::Iterator(std::vector<int>{5, 9, 1, 6, 7, 8, 3, 2, 4})
+    .top_k(3) != std::vector<int>{9, 8, 7}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::list<int>{5, 9, 1, 6, 7, 8, 3, 2, 4})
+    .top_k(4, std::greater<>()) != std::list<int>{1, 2, 3, 4}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<int>{2, 1}).top_k(5) != std::vector<int>{2, 1} or jmixin::Iterator(std::vector<int>{2, 1}).top_k(0).empty() == false) {
+    return 1;
+  }
+
+  jmixin::Executor executor(2);
+
+  std::vector<int> items(10000);
+
+  std::iota(std::begin(items), std::end(items), 0);
+  std::shuffle(std::begin(items), std::end(items), std::mt19937{42});
+
+  if (jmixin::Iterator(items)
+    .top_k(jmixin::par(executor, 100), 5, std::less<>()) != std::vector<int>{9999, 9998, 9997, 9996, 9995}) {
+    return 1;
+  }
+
+  return 0;
+}
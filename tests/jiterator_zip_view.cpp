@@ -0,0 +1,54 @@
+#include "jmixin/jiterator.h"
+
+#include <list>
+
+template<typename T, typename Other>
+  concept zippable = requires (T &&items, Other &&other) {
+    std::forward<T>(items).zip_view(std::forward<Other>(other));
+  };
+
+int main()
+{
+  jmixin::Iterator<std::vector<std::string>> names {std::vector<std::string>{"a", "b", "c", "d"}};
+  std::list<int> ages {10, 20, 30, 40};
+  std::vector<double> weights {1.0, 2.0, 3.0, 4.0};
+
+  auto result = names.zip_view(ages, weights)
+    .filter([](const auto &item) {
+        return std::get<1>(item) > 10;
+    })
+    .map([](const auto &item) {
+        return std::get<0>(item) + std::to_string(std::get<1>(item) + static_cast<int>(std::get<2>(item)));
+    })
+    .collect();
+
+  if (result != std::vector<std::string>{"b22", "c33", "d44"}) {
+    return 1;
+  }
+
+  bool same = true;
+
+  names.zip_view(ages).for_each([&](const auto &item) {
+      same = same and &std::get<0>(item) >= names.data() and &std::get<0>(item) < names.data() + names.size();
+  });
+
+  if (same == false) {
+    return 1;
+  }
+
+  // the references would outlive temporaries
+  static_assert(zippable<jmixin::Iterator<std::vector<int>> &, std::vector<int> &>);
+  static_assert(zippable<jmixin::Iterator<std::vector<int>>, std::vector<int> &> == false);
+  static_assert(zippable<jmixin::Iterator<std::vector<int>> &, std::vector<int>> == false);
+
+  std::vector<int> single {1};
+
+  try {
+    names.zip_view(single);
+
+    return 1;
+  } catch (std::runtime_error &) {
+  }
+
+  return 0;
+}
@@ -0,0 +1,18 @@
+#include "jmixin/jiterator.h"
+#include "jmixin/jgenerator.h"
+
+int main()
+{
+  // reservoir sampling, a single pass over a stream
+  auto reservoir = jmixin::iota(0, 1000).lazy().sample(10, jmixin::Xoshiro256(3));
+
+  if (reservoir.size() != 10 or reservoir.all([](int item) { return item >= 0 and item < 1000; }) == false) {
+    return 1;
+  }
+
+  if (jmixin::iota(0, 3).lazy().sample(10).sort() != std::vector<int>{0, 1, 2}) {
+    return 1;
+  }
+
+  return 0;
+}
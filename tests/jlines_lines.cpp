@@ -0,0 +1,72 @@
+#include "jmixin/jlines.h"
+
+#include <cstdio>
+#include <filesystem>
+
+int main()
+{
+  const char *path = "jlines_lines.txt";
+
+  {
+    std::ofstream out(path);
+
+    out << "first\n\nthird line\nlast";
+  }
+
+  auto items = jmixin::lines(path);
+
+  if (items.size() != 4 or items[0] != "first" or items[1] != "" or items[2] != "third line" or items[3] != "last") {
+    return 1;
+  }
+
+  // the views outlive the first result, since every container keeps the file
+  auto filtered = jmixin::Iterator<jmixin::Lines>{};
+
+  {
+    auto lines = jmixin::lines(path);
+
+    filtered = lines.copy().filter([](std::string_view item) { return item.empty() == false; });
+  }
+
+  // and so do the containers collected from a lazy view of a temporary
+  auto collected = jmixin::lines(path).lazy().filter([](std::string_view item) { return item.size() > 4; }).collect();
+
+  std::remove(path);
+
+  if (filtered.size() != 3 or filtered[1] != "third line" or filtered.get_allocator().file()->mapped() == false) {
+    return 1;
+  }
+
+  if (collected.size() != 2 or collected[0] != "first" or collected[1] != "third line") {
+    return 1;
+  }
+
+  {
+    std::ofstream out(path);
+
+    out << "a\nb\n";
+  }
+
+  if (jmixin::lines(path).size() != 2) {
+    return 1;
+  }
+
+  std::remove(path);
+
+  if (std::filesystem::exists("/proc/self/status") == true) {
+    auto status = jmixin::lines("/proc/self/status");
+
+    if (status.empty() == true or status[0].starts_with("Name:") == false or status.get_allocator().file()->mapped() == true) {
+      return 1;
+    }
+  }
+
+  try {
+    jmixin::lines("jlines_lines.missing");
+
+    return 1;
+  } catch (const std::runtime_error &) {
+  }
+
+  return 0;
+}
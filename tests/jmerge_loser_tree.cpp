@@ -0,0 +1,51 @@
+#include "jmixin/jiterator.h"
+
+#include <list>
+#include <string>
+#include <vector>
+
+int main()
+{
+  std::vector<std::list<int>> lists {{1, 4, 7}, {}, {2, 2, 9}, {0, 4}, {3}};
+  std::vector<std::pair<std::list<int>::const_iterator, std::list<int>::const_iterator>> runs;
+
+  for (const auto &list : lists) {
+    runs.emplace_back(std::begin(list), std::end(list));
+  }
+
+  jmixin::LoserTree tree(runs);
+  std::vector<int> items;
+  std::vector<std::size_t> sources;
+
+  for (; tree.empty() == false; tree.pop()) {
+    items.push_back(tree.top());
+    sources.push_back(tree.run());
+  }
+
+  if (items != std::vector<int>{0, 1, 2, 2, 3, 4, 4, 7, 9}) {
+    return 1;
+  }
+
+  // equal items come from the first run first
+  if (sources != std::vector<std::size_t>{3, 0, 2, 2, 4, 0, 3, 0, 2}) {
+    return 1;
+  }
+
+  if (jmixin::LoserTree<std::vector<int>::const_iterator>({}).empty() == false) {
+    return 1;
+  }
+
+  // descending
+  std::vector<std::string> a {"pear", "kiwi", "apple"};
+  std::vector<std::string> b {"plum", "fig"};
+  std::vector<std::string> c {"lime"};
+  std::vector<std::string> merged;
+
+  jmixin::merge_runs(std::vector{std::pair{a.cbegin(), a.cend()}, {b.cbegin(), b.cend()}, {c.cbegin(), c.cend()}}, std::back_inserter(merged), std::greater<>());
+
+  if (merged != std::vector<std::string>{"plum", "pear", "lime", "kiwi", "fig", "apple"}) {
+    return 1;
+  }
+
+  return 0;
+}
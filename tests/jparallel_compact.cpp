@@ -0,0 +1,51 @@
+#include "jmixin/jiterator.h"
+
+#include <atomic>
+#include <execution>
+
+int main()
+{
+  std::vector<int> items(1000000);
+
+  std::iota(std::begin(items), std::end(items), 0);
+
+  std::vector<int> odds {items};
+
+  jmixin::parallel::compact(std::execution::par, odds, [](const auto &item, std::size_t index) {
+      return item % 2 == 1 and static_cast<std::size_t>(item) == index;
+  });
+
+  if (odds.size() != 500000 or odds[0] != 1 or odds.back() != 999999) {
+    return 1;
+  }
+
+  // the predicate runs once per item
+  std::atomic<std::size_t> calls = 0;
+  std::vector<int> evens {items};
+
+  jmixin::parallel::compact(std::execution::par, evens, [&calls](const auto &item, std::size_t) {
+      calls++;
+
+      return item % 2 == 0;
+  });
+
+  if (calls != items.size() or evens.size() != 500000 or evens.back() != 999998) {
+    return 1;
+  }
+
+  auto stepped = jmixin::Iterator(items).step(std::execution::par, 3);
+
+  if (stepped.size() != 333334 or stepped[1] != 3 or stepped.back() != 999999) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(items).skip(std::execution::par, 999998) != std::vector<int>{999998, 999999}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(items).take(std::execution::par, 3) != std::vector<int>{0, 1, 2}) {
+    return 1;
+  }
+
+  return 0;
+}
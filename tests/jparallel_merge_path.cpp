@@ -0,0 +1,84 @@
+#include "jmixin/jiterator.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+int main()
+{
+  jmixin::Executor executor(3);
+  jmixin::Xoshiro256 engine(7);
+
+  // runs of equal items longer than a slice, so the splits must move to keys
+  for (std::size_t grain : {1, 7, 64, 100000}) {
+    auto policy = jmixin::par(executor, grain);
+
+    std::vector<int> a(5000);
+    std::vector<int> b(3000);
+
+    for (auto &item : a) {
+      item = static_cast<int>(engine() % 300);
+    }
+
+    for (auto &item : b) {
+      item = static_cast<int>(engine() % 200);
+    }
+
+    std::sort(std::begin(a), std::end(a), std::greater<>());
+    std::sort(std::begin(b), std::end(b), std::greater<>());
+
+    auto check = [&](auto algorithm, auto parallel, std::size_t bound) {
+      std::vector<int> expected;
+      std::vector<int> result(bound);
+
+      algorithm(std::begin(a), std::end(a), std::begin(b), std::end(b), std::back_inserter(expected), std::greater<>());
+
+      result.erase(parallel(policy, std::begin(a), std::end(a), std::begin(b), std::end(b), std::begin(result), std::greater<>()), std::end(result));
+
+      return result == expected;
+    };
+
+    if (check([](auto... args) { return std::merge(args...); }, [](auto... args) { return jmixin::parallel::merge(args...); }, a.size() + b.size()) == false) {
+      return 1;
+    }
+
+    if (check([](auto... args) { return std::set_union(args...); }, [](auto... args) { return jmixin::parallel::set_union(args...); }, a.size() + b.size()) == false) {
+      return 1;
+    }
+
+    if (check([](auto... args) { return std::set_intersection(args...); }, [](auto... args) { return jmixin::parallel::set_intersection(args...); }, b.size()) == false) {
+      return 1;
+    }
+
+    if (check([](auto... args) { return std::set_difference(args...); }, [](auto... args) { return jmixin::parallel::set_difference(args...); }, a.size()) == false) {
+      return 1;
+    }
+  }
+
+  // the Iterator overloads
+  std::vector<int> a {1, 2, 2, 2, 3, 5, 8, 8, 9};
+  std::vector<int> b {2, 2, 4, 5, 8, 10};
+  auto policy = jmixin::par(executor, 2);
+
+  if (jmixin::Iterator(a).merge(policy, b) != std::vector<int>{1, 2, 2, 2, 2, 2, 3, 4, 5, 5, 8, 8, 8, 9, 10}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(a).union_set(policy, b) != std::vector<int>{1, 2, 2, 2, 3, 4, 5, 8, 8, 9, 10}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(a).intersection(policy, b) != std::vector<int>{2, 2, 5, 8}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(a).difference(policy, b) != std::vector<int>{1, 2, 3, 8, 9}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(a).complement(policy, b) != std::vector<int>{4, 10}) {
+    return 1;
+  }
+
+  return 0;
+}
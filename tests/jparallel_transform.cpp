@@ -0,0 +1,57 @@
+#include "jmixin/jiterator.h"
+
+#include <execution>
+#include <set>
+#include <string>
+
+int main()
+{
+  std::vector<int> items(1000000);
+
+  std::iota(std::begin(items), std::end(items), 0);
+
+  auto squares = jmixin::Iterator(items)
+    .map<std::vector<long>>(std::execution::par, [](const auto &item) {
+        return static_cast<long>(item)*item;
+    });
+
+  if (squares.size() != items.size() or squares[1000] != 1000000 or squares.back() != 999998000001) {
+    return 1;
+  }
+
+  auto names = jmixin::Iterator(std::vector<int>{3, 1, 2, 3})
+    .map<std::set<std::string>>(std::execution::par, [](const auto &item) {
+        return std::to_string(item);
+    });
+
+  if (names != std::set<std::string>{"1", "2", "3"}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(items).copy(std::execution::par) != items) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(items).copy_n(std::execution::par, 3) != std::vector<int>{0, 1, 2}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<int>{3, 4}).append(std::execution::par, std::vector<int>{5}).prepend(std::execution::par, std::vector<int>{1, 2}) != std::vector<int>{1, 2, 3, 4, 5}) {
+    return 1;
+  }
+
+  if (jmixin::Iterator(std::vector<int>{1, 3, 5}).merge(std::execution::par, std::vector<int>{2, 4}) != std::vector<int>{1, 2, 3, 4, 5}) {
+    return 1;
+  }
+
+  auto halves = jmixin::Iterator(items)
+    .stable_partition(std::execution::par, [](const auto &item) {
+        return item % 2 == 0;
+    });
+
+  if (halves[0].size() != 500000 or halves[0][1] != 2 or halves[1][1] != 3) {
+    return 1;
+  }
+
+  return 0;
+}
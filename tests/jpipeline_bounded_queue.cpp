@@ -0,0 +1,77 @@
+#include "jmixin/jpipeline.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+int main()
+{
+  jmixin::BoundedQueue<int> queue(3);
+
+  if (queue.capacity() != 4) {
+    return 1;
+  }
+
+  for (int i=0; i<4; i++) {
+    if (queue.try_push(i) == false) {
+      return 1;
+    }
+  }
+
+  int value = 9;
+
+  if (queue.try_push(value) == true or queue.try_pop(value) == false or value != 0) {
+    return 1;
+  }
+
+  while (queue.try_pop(value) == true) {
+  }
+
+  if (value != 3) {
+    return 1;
+  }
+
+  // every item goes to exactly one consumer
+  constexpr int producers = 2;
+  constexpr int items = 10000;
+
+  jmixin::BoundedQueue<int> shared(16);
+  std::atomic<long> sum {0};
+  std::atomic<int> count {0};
+  std::vector<std::thread> threads;
+
+  for (int p=0; p<producers; p++) {
+    threads.emplace_back([&]() {
+        for (int i=1; i<=items; i++) {
+          int item = i;
+
+          while (shared.try_push(item) == false) {
+            std::this_thread::yield();
+          }
+        }
+    });
+
+    threads.emplace_back([&]() {
+        int item;
+
+        while (count.load() < producers*items) {
+          if (shared.try_pop(item) == true) {
+            sum += item;
+            count++;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  if (count != producers*items or sum != producers*(items*(items + 1L)/2)) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,35 @@
+#include "jmixin/jpipeline.h"
+
+#include <vector>
+
+int main()
+{
+  auto pipeline = jmixin::pipeline(std::vector<int>{1, 2, 3, 4, 5, 6})
+    .filter("even", [](int value) {
+        return value % 2 == 0;
+    })
+    .map("half", [](int value) {
+        return value/2;
+    });
+
+  if (pipeline.collect() != std::vector<int>{1, 2, 3}) {
+    return 1;
+  }
+
+  auto stats = pipeline.stats();
+
+  if (stats[0].items != 6 or stats[1].items != 3 or stats[2].items != 3) {
+    return 1;
+  }
+
+  auto none = jmixin::pipeline(std::vector<int>{1, 3, 5})
+    .filter("even", [](int value) {
+        return value % 2 == 0;
+    }, 2);
+
+  if (none.collect().empty() == false) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+#include "jmixin/jpipeline.h"
+
+#include <chrono>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main()
+{
+  auto pipeline = jmixin::pipeline(std::vector<int>{1, 2, 3, 4, 5}, 2)
+    .map("square", [](int value) {
+        return value*value;
+    })
+    .map("text", [](int value) {
+        return std::to_string(value);
+    });
+
+  if (pipeline.collect() != std::vector<std::string>{"1", "4", "9", "16", "25"}) {
+    return 1;
+  }
+
+  auto stats = pipeline.stats();
+
+  if (stats.size() != 3 or stats[0].name != "source" or stats[1].name != "square" or stats[2].items != 5) {
+    return 1;
+  }
+
+  // more threads in a stage do not keep the order
+  long sum = 0;
+
+  auto parallel = jmixin::Pipeline<int>([](auto &&sink) {
+      for (int i=1; i<=1000; i++) {
+        if (sink(i) == false) {
+          return;
+        }
+      }
+  }, 8).map("double", [](int value) {
+      return 2L*value;
+  }, 3);
+
+  parallel.for_each([&](long value) {
+      sum += value;
+  });
+
+  if (sum != 1001000 or parallel.stats()[1].threads != 3 or parallel.stats()[1].items != 1000) {
+    return 1;
+  }
+
+  // the first error of a stage stops the pipeline and is rethrown
+  auto failing = jmixin::pipeline(std::vector<int>(10000, 1), 4)
+    .map("fail", [](int value) {
+        if (value == 1) {
+          throw std::runtime_error("fail");
+        }
+
+        return value;
+    });
+
+  try {
+    failing.collect();
+
+    return 1;
+  } catch (std::runtime_error &) {
+  }
+
+  try {
+    failing.collect();
+
+    return 1;
+  } catch (std::runtime_error &) {
+  }
+
+  // the threads waiting on a slow stage sleep instead of burning the cpu
+  auto slow = jmixin::pipeline(std::vector<int>{1, 2, 3})
+    .map("sleep", [](int value) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        return value;
+    })
+    .map("next", [](int value) {
+        return value + 1;
+    });
+
+  std::clock_t cpu = std::clock();
+
+  if (slow.collect() != std::vector<int>{2, 3, 4} or std::clock() - cpu > CLOCKS_PER_SEC/10) {
+    return 1;
+  }
+
+  // a consumer error wakes the source blocked on a full queue
+  auto blocked = jmixin::pipeline(std::vector<int>(10000, 1), 2);
+
+  try {
+    blocked.for_each([](int) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        throw std::runtime_error("fail");
+    });
+
+    return 1;
+  } catch (std::runtime_error &) {
+  }
+
+  return 0;
+}
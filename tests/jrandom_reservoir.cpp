@@ -0,0 +1,53 @@
+#include "jmixin/jrandom.h"
+
+#include <algorithm>
+#include <string>
+
+int main()
+{
+  jmixin::Xoshiro256 engine(7);
+
+  {
+    jmixin::random::Reservoir<std::string, jmixin::Xoshiro256> reservoir(5, engine);
+
+    reservoir.push("a");
+    reservoir.push("b");
+
+    if (std::move(reservoir).items() != std::vector<std::string>{"a", "b"}) {
+      return 1;
+    }
+  }
+
+  // every item has the same chance, k/n, to be in the sample
+  constexpr int n = 20;
+  constexpr int k = 4;
+  constexpr int trials = 20000;
+
+  std::vector<int> hits(n);
+
+  for (int trial=0; trial<trials; trial++) {
+    jmixin::random::Reservoir<int, jmixin::Xoshiro256> reservoir(k, engine);
+
+    for (int i=0; i<n; i++) {
+      reservoir.push(i);
+    }
+
+    auto items = std::move(reservoir).items();
+
+    if (items.size() != k) {
+      return 1;
+    }
+
+    for (auto item : items) {
+      hits[item]++;
+    }
+  }
+
+  auto [min, max] = std::minmax_element(std::begin(hits), std::end(hits));
+
+  if (*min < trials*k/n*0.9 or *max > trials*k/n*1.1) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,55 @@
+#include "jmixin/jrandom.h"
+
+#include <random>
+
+int main()
+{
+  static_assert(std::uniform_random_bit_generator<jmixin::Xoshiro256>);
+
+  jmixin::Xoshiro256 engine(42);
+
+  if (engine() != 0x15780b2e0c2ec716 or engine() != 0x6104d9866d113a7e or engine() != 0xae17533239e499a1) {
+    return 1;
+  }
+
+  engine.seed(42);
+
+  if (engine != jmixin::Xoshiro256(42)) {
+    return 1;
+  }
+
+  jmixin::Xoshiro256 jumped = engine;
+
+  jumped.jump();
+
+  if (jumped == engine or jumped() == engine()) {
+    return 1;
+  }
+
+  for (int i=0; i<1000; i++) {
+    if (jmixin::random::bounded(engine, 7) >= 7) {
+      return 1;
+    }
+
+    double unit = jmixin::random::unit(engine);
+
+    if (unit <= 0.0 or unit >= 1.0) {
+      return 1;
+    }
+  }
+
+  // engines with a smaller range work as well
+  std::mt19937 other(42);
+
+  for (int i=0; i<1000; i++) {
+    if (jmixin::random::bounded(other, 3) >= 3) {
+      return 1;
+    }
+  }
+
+  if (&jmixin::default_engine() != &jmixin::default_engine()) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,52 @@
+#include "jmixin/jsimd.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+template<typename T>
+  bool check()
+  {
+    std::mt19937 generator{42};
+
+    for (std::size_t n : {1, 2, 3, 7, 8, 15, 16, 17, 31, 33, 100, 1001}) {
+      std::vector<T> items(n);
+      std::vector<T> ones(n, T{1});
+
+      for (auto &item : items) {
+        item = static_cast<T>(generator() % 100) - 50;
+      }
+
+      ones[n/2] = 2;
+      ones[n - 1] = 3;
+
+      for (auto level : {jmixin::simd::isa::scalar, jmixin::simd::isa::sse2, jmixin::simd::isa::avx2}) {
+        jmixin::simd::limit(level);
+
+        auto min = std::min_element(std::begin(items), std::end(items));
+        auto max = std::max_element(std::begin(items), std::end(items));
+        auto minmax = jmixin::simd::minmax(items.data(), n);
+
+        if (jmixin::simd::sum(items.data(), n) != std::accumulate(std::begin(items), std::end(items), T{0}) or
+            jmixin::simd::product(ones.data(), n) != std::accumulate(std::begin(ones), std::end(ones), T{1}, std::multiplies<>()) or
+            jmixin::simd::min(items.data(), n) != *min or
+            jmixin::simd::max(items.data(), n) != *max or
+            minmax.min != *min or minmax.min_position != static_cast<std::size_t>(min - std::begin(items)) or
+            minmax.max != *max or minmax.max_position != static_cast<std::size_t>(max - std::begin(items))) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+int main()
+{
+  if (check<int>() == false or check<long>() == false or check<float>() == false or check<double>() == false) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include "jmixin/jsort.h"
+#include "jmixin/jstring.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+int main()
+{
+  jmixin::Xoshiro256 engine(1);
+
+  std::vector<std::string> items;
+
+  for (int i=0; i<5000; i++) {
+    std::string item = i % 3 == 0 ? "common/prefix/" : "";
+
+    for (std::size_t j=jmixin::random::bounded(engine, 8); j>0; j--) {
+      item.push_back("ab\xff"[jmixin::random::bounded(engine, 3)]);
+    }
+
+    items.push_back(item);
+  }
+
+  auto expected = items;
+
+  std::sort(std::begin(expected), std::end(expected));
+
+  jmixin::sorting::multikey_quicksort(std::begin(items), std::end(items));
+
+  if (items != expected) {
+    return 1;
+  }
+
+  auto strings = jmixin::Iterator(std::vector<jmixin::String>{"pear", "apple", "", "app", "banana"}).sort();
+
+  if (strings != std::vector<jmixin::String>{"", "app", "apple", "banana", "pear"}) {
+    return 1;
+  }
+
+  // pointers are ordered by address, as the comparator says
+  static const char text[] = "b\0a\0c";
+
+  std::vector<const char *> pointers {text + 4, text, text + 2};
+
+  if (jmixin::Iterator(pointers).sort() != std::vector<const char *>{text, text + 2, text + 4}) {
+    return 1;
+  }
+
+  return 0;
+}
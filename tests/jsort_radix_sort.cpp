@@ -0,0 +1,67 @@
+#include "jmixin/jsort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+template<typename T>
+  bool check(std::vector<T> items)
+  {
+    auto expected = items;
+
+    std::sort(std::begin(expected), std::end(expected));
+
+    jmixin::sorting::radix_sort(std::begin(items), std::end(items), std::identity());
+
+    if (items != expected) {
+      return false;
+    }
+
+    std::reverse(std::begin(expected), std::end(expected));
+
+    jmixin::sorting::radix_sort(std::begin(items), std::end(items), std::identity(), true);
+
+    return items == expected;
+  }
+
+int main()
+{
+  jmixin::Xoshiro256 engine(1);
+
+  std::vector<std::uint64_t> ids(10000);
+  std::vector<int> ints(10000);
+  std::vector<double> doubles(10000);
+  std::vector<std::int8_t> bytes(10000);
+
+  for (std::size_t i=0; i<ids.size(); i++) {
+    ids[i] = engine();
+    ints[i] = static_cast<int>(engine());
+    doubles[i] = (jmixin::random::unit(engine) - 0.5)*1e6;
+    bytes[i] = static_cast<std::int8_t>(engine());
+  }
+
+  ints.push_back(std::numeric_limits<int>::min());
+  ints.push_back(std::numeric_limits<int>::max());
+  doubles.push_back(-std::numeric_limits<double>::infinity());
+  doubles.push_back(std::numeric_limits<double>::max());
+
+  if (check(ids) == false or check(ints) == false or check(doubles) == false or check(bytes) == false) {
+    return 1;
+  }
+
+  // stable by the key
+  std::vector<std::pair<int, int>> pairs;
+
+  for (int i=0; i<1000; i++) {
+    pairs.emplace_back(i % 7 - 3, i);
+  }
+
+  jmixin::sorting::radix_sort(std::begin(pairs), std::end(pairs), [](const auto &item) { return item.first; });
+
+  if (std::is_sorted(std::begin(pairs), std::end(pairs)) == false) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,54 @@
+#include "jmixin/jiterator.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+int main()
+{
+  jmixin::Executor executor(3);
+  jmixin::Xoshiro256 engine(1);
+
+  std::vector<long> numbers(200000);
+
+  for (auto &number : numbers) {
+    number = static_cast<long>(engine() % 1000) - 500;
+  }
+
+  auto expected = numbers;
+
+  std::sort(std::begin(expected), std::end(expected));
+
+  if (jmixin::Iterator(numbers).sort(jmixin::par(executor), std::less<>()) != expected) {
+    return 1;
+  }
+
+  std::reverse(std::begin(expected), std::end(expected));
+
+  if (jmixin::Iterator(numbers).sort(jmixin::par(executor), std::greater<>()) != expected) {
+    return 1;
+  }
+
+  // generic comparator
+  std::vector<std::string> strings;
+
+  for (std::size_t i=0; i<100000; i++) {
+    strings.push_back(std::to_string(engine() % 100000));
+  }
+
+  auto by_size = [](const std::string &a, const std::string &b) {
+    return a.size() < b.size() or (a.size() == b.size() and a < b);
+  };
+
+  auto sorted = strings;
+
+  std::sort(std::begin(sorted), std::end(sorted), by_size);
+
+  jmixin::parallel::sort(jmixin::par(executor), std::begin(strings), std::end(strings), by_size);
+
+  if (strings != sorted) {
+    return 1;
+  }
+
+  return 0;
+}
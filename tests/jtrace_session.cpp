@@ -0,0 +1,94 @@
+#ifndef JMIXIN_JITERATOR_TRACE
+#define JMIXIN_JITERATOR_TRACE
+#endif
+
+#include "jmixin/jiterator.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+void * operator new(std::size_t size)
+{
+  jmixin::trace::allocated(size);
+
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+int main()
+{
+  std::vector<jmixin::trace::Event> events;
+
+  jmixin::Iterator(std::vector<int>{1, 2, 3}).filter([](int) { return true; });
+
+  {
+    jmixin::trace::Session session([&events](const jmixin::trace::Event &event) {
+        events.push_back(event);
+    });
+
+    jmixin::Iterator(std::vector<int>{5, 1, 4, 2, 3, 6})
+      .filter([](int item) { return item > 1; })
+      .map<std::vector<std::string>>([](int item) { return std::to_string(item); })
+      .bottom_k(2);
+  }
+
+  jmixin::Iterator(std::vector<int>{1, 2, 3}).filter([](int) { return true; });
+
+  // events are recorded when the methods end, so top_k comes before bottom_k
+  if (events.size() != 4) {
+    return 1;
+  }
+
+  if (std::string(events[0].name) != "filter" or events[0].input != 6 or events[0].output != 5 or events[0].allocations != 0) {
+    return 1;
+  }
+
+  if (std::string(events[1].name) != "map" or events[1].input != 5 or events[1].output != 5 or events[1].allocations == 0 or events[1].bytes == 0) {
+    return 1;
+  }
+
+  if (std::string(events[2].name) != "top_k" or events[2].depth != 1 or std::string(events[3].name) != "bottom_k" or events[3].depth != 0 or events[3].output != 2) {
+    return 1;
+  }
+
+  if (events[3].start > events[2].start or events[3].duration < events[2].duration) {
+    return 1;
+  }
+
+  const char *path = "jtrace_session.json";
+
+  {
+    jmixin::trace::Session session(path);
+
+    jmixin::Iterator(std::vector<int>{3, 1, 2}).sort().unique();
+  }
+
+  std::ifstream in(path);
+  std::stringstream json;
+
+  json << in.rdbuf();
+
+  std::remove(path);
+
+  if (json.str().find("{\"traceEvents\": [") != 0 or json.str().find("\"name\": \"sort\", \"ph\": \"X\"") == std::string::npos or json.str().find("\"name\": \"unique\"") == std::string::npos) {
+    return 1;
+  }
+
+  return 0;
+}